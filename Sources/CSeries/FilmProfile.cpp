@@ -26,6 +26,50 @@
 
 #include "Plugins.hpp"
 
+static FilmProfile alephbet0_9 = {
+        true,  // keyframe_fix
+        false, // damage_aggressor_last_in_tag
+        true,  // swipe_nearby_items_fix
+        true,  // initial_monster_fix
+        true,  // long_distance_physics
+        true,  // animate_items
+        true,  // inexplicable_pin_change
+        false, // increased_dynamic_limits_1_0
+        true,  // increased_dynamic_limits_1_1
+        true,  // line_is_obstructed_fix
+        false, // a1_smg
+        true,  // infinity_smg
+        true,  // use_vertical_kick_threshold
+        true,  // infinity_tag_fix
+        true,  // adjacent_polygons_always_intersect
+        true,  // early_object_initialization
+        true,  // fix_sliding_on_platforms
+        true,  // prevent_dead_projectile_owners
+        true,  // validate_random_ranged_attack
+        true,  // allow_short_kamikaze
+        true,  // ketchup_fix
+        false, // lua_increments_rng
+        true,  // destroy_players_ball_fix
+        true,  // calculate_terminal_lines_correctly
+        true,  // key_frame_zero_shrapnel_fix
+        true,  // count_dead_dropped_items_correctly
+        true,  // m1_low_gravity_projectiles
+        true,  // m1_buggy_repair_goal
+        false, // find_action_key_target_has_side_effects
+        true,  // m1_object_unused
+        true,  // m1_platform_flood
+        true,  // m1_teleport_without_delay
+        true,  // better_terminal_word_wrap
+        true,  // lua_monster_killed_trigger_fix
+        true,  // chip_insertion_ignores_tag_state
+        true,  // page_up_past_full_width_term_pict
+        true,  // fix_destroy_scenery_random_frame
+        true,  // m1_reload_sound
+        true,  // m1_landscape_effects
+        true,  // m1_bce_pickup
+        true,  // monster_perception_opt_in
+};
+
 static FilmProfile alephone1_7 = {
         true,  // keyframe_fix
         false, // damage_aggressor_last_in_tag
@@ -67,6 +111,7 @@ static FilmProfile alephone1_7 = {
         true,  // m1_reload_sound
         true,  // m1_landscape_effects
         true,  // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile alephone1_4 = {
@@ -110,6 +155,7 @@ static FilmProfile alephone1_4 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 
@@ -154,6 +200,7 @@ static FilmProfile alephone1_3 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile alephone1_2 = {
@@ -197,6 +244,7 @@ static FilmProfile alephone1_2 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile alephone1_1 = {
@@ -240,6 +288,7 @@ static FilmProfile alephone1_1 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile alephone1_0 = {
@@ -283,6 +332,7 @@ static FilmProfile alephone1_0 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile marathon2 = {
@@ -326,6 +376,7 @@ static FilmProfile marathon2 = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
 static FilmProfile marathon_infinity = {
@@ -369,9 +420,10 @@ static FilmProfile marathon_infinity = {
         false, // m1_reload_sound
         false, // m1_landscape_effects
         false, // m1_bce_pickup
+        false, // monster_perception_opt_in
 };
 
-FilmProfile film_profile = alephone1_7;
+FilmProfile film_profile = alephbet0_9;
 
 extern void LoadBaseMMLScripts(bool load_menu_mml_only);
 extern void ResetAllMMLValues();
@@ -379,7 +431,7 @@ extern void ResetAllMMLValues();
 void load_film_profile(FilmProfileType type, bool reload_mml) {
     switch (type) {
         case FILM_PROFILE_DEFAULT:
-            film_profile = alephone1_7;
+            film_profile = alephbet0_9;
             break;
         case FILM_PROFILE_MARATHON_2:
             film_profile = marathon2;
@@ -402,6 +454,9 @@ void load_film_profile(FilmProfileType type, bool reload_mml) {
         case FILM_PROFILE_ALEPH_ONE_1_4:
             film_profile = alephone1_4;
             break;
+        case FILM_PROFILE_ALEPH_ONE_1_7:
+            film_profile = alephone1_7;
+            break;
     }
 
     if (reload_mml) {
@@ -111,6 +111,9 @@ struct FilmProfile {
     bool m1_reload_sound;      // play the reload sound on the key frame
     bool m1_landscape_effects; // projectiles detonate on M1 landscapes
     bool m1_bce_pickup;        // you can pick up another BCE if you already have one
+
+    // Aleph Bet 0.9 changes
+    bool monster_perception_opt_in; // scenarios can have several monsters look for targets each tick (MML)
 };
 
 extern FilmProfile film_profile;
@@ -124,6 +127,8 @@ enum FilmProfileType {
     FILM_PROFILE_ALEPH_ONE_1_3,
     FILM_PROFILE_ALEPH_ONE_1_4,
     FILM_PROFILE_DEFAULT,
+    // after DEFAULT, since preferences store these by number
+    FILM_PROFILE_ALEPH_ONE_1_7,
 };
 
 void load_film_profile(FilmProfileType type, bool reload_mml = true);
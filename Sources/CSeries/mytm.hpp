@@ -45,6 +45,9 @@ extern void myTMCleanup(bool waitForFinishers);
 extern bool take_mytm_mutex();
 extern bool release_mytm_mutex();
 
+// Like take_mytm_mutex(), but gives up right away if someone else has the mutex
+extern bool try_take_mytm_mutex();
+
 // ghs: exception-safe version of above
 class MyTMMutexTaker {
   public:
@@ -107,6 +107,8 @@ bool take_mytm_mutex() {
     return success;
 }
 
+bool try_take_mytm_mutex() { return SDL_TryLockMutex(sTMTaskMutex) == 0; }
+
 bool release_mytm_mutex() {
     bool success = (SDL_UnlockMutex(sTMTaskMutex) != -1);
     if (!success)
@@ -72,9 +72,11 @@ int Movie::Movie_EncodeThread(void* arg) { return 0; }
 
 void Movie::EncodeThread() {}
 
-void Movie::EncodeVideo(bool last) {}
+size_t Movie::ClaimFrame() { return 0; }
 
-void Movie::EncodeAudio(bool last) {}
+void Movie::EncodeVideo(QueuedFrame* frame) {}
+
+void Movie::EncodeAudio(QueuedFrame* frame) {}
 
 long Movie::GetCurrentAudioTimeStamp() { return 0; }
 
@@ -134,6 +136,11 @@ struct libav_vars {
 };
 typedef struct libav_vars libav_vars_t;
 
+enum {
+    FRAME_QUEUE_SIZE      = 8, // frames waiting for the encoder
+    READBACK_BUFFER_COUNT = 3  // frames being read back from OpenGL
+};
+
 int ScaleQuality(int quality, int zeroLevel, int fiftyLevel, int hundredLevel) {
     switch (quality) {
         case 50:
@@ -158,11 +165,11 @@ int ScaleQuality(int quality, int zeroLevel, int fiftyLevel, int hundredLevel) {
 }
 
 Movie::Movie()
-    : moviefile(""), temp_surface(NULL), av(NULL), encodeThread(NULL), encodeReady(NULL),
+    : moviefile(""), fill_index(0), encode_index(0), av(NULL), encodeThread(NULL), encodeReady(NULL),
 #ifdef HAVE_OPENGL
-      frameBufferObject(nullptr),
+      frameBufferObject(nullptr), readback_index(0),
 #endif
-      fillReady(NULL), stillEncoding(0) {
+      fillReady(NULL) {
     av = new libav_vars_t;
     memset(av, 0, sizeof(libav_vars_t));
 }
@@ -206,14 +213,6 @@ bool Movie::Setup() {
 
     const auto fps = std::max(get_fps_target(), static_cast<int16_t>(30));
 
-    temp_surface = SDL_CreateRGBSurface(SDL_SWSURFACE, view_rect.w, view_rect.h, 32, 0x00ff'0000, 0x0000'ff00,
-                                        0x0000'00ff, 0);
-
-    if (temp_surface == NULL) {
-        ThrowUserError("Could not create SDL surface");
-        return false;
-    }
-
     av->ffmpeg_file = SDL_ffmpegCreate(moviefile.c_str());
 
     if (!av->ffmpeg_file) {
@@ -305,19 +304,27 @@ bool Movie::Setup() {
         return false;
     }
 
-    // set up our threads and intermediate storage
-    videobuf.resize(view_rect.w * view_rect.h * 4 + 10'000);
-    audiobuf.resize(2 * in_bps * OpenALManager::Get()->GetFrequency() / fps);
-
     // TODO: fixme!
     if (OpenALManager::Get()->GetFrequency() % fps != 0) {
         ThrowUserError("Audio buffer size is non-integer; try lowering FPS target");
         return false;
     }
 
-    encodeReady   = SDL_CreateSemaphore(0);
-    fillReady     = SDL_CreateSemaphore(1);
-    stillEncoding = true;
+    // set up our threads and intermediate storage
+    frames.resize(FRAME_QUEUE_SIZE);
+    for (auto& frame : frames) {
+        frame.videobuf.resize(view_rect.w * view_rect.h * 4);
+        frame.audiobuf.resize(2 * in_bps * OpenALManager::Get()->GetFrequency() / fps);
+        frame.surface = SDL_CreateRGBSurfaceFrom(frame.videobuf.data(), view_rect.w, view_rect.h, 32, view_rect.w * 4,
+                                                 0x00ff'0000, 0x0000'ff00, 0x0000'00ff, 0);
+        if (!frame.surface) {
+            ThrowUserError("Could not create SDL surface");
+            return false;
+        }
+    }
+
+    encodeReady = SDL_CreateSemaphore(0);
+    fillReady   = SDL_CreateSemaphore(FRAME_QUEUE_SIZE);
     if (!encodeReady || !fillReady) {
         ThrowUserError("Could not create movie thread semaphores");
         return false;
@@ -332,6 +339,15 @@ bool Movie::Setup() {
 #ifdef HAVE_OPENGL
     if (MainScreenIsOpenGL()) {
         frameBufferObject = std::make_unique<FBO>(view_rect.w, view_rect.h);
+
+        readbacks.resize(READBACK_BUFFER_COUNT);
+        for (auto& readback : readbacks) {
+            glGenBuffers(1, &readback.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, view_rect.w * view_rect.h * 4, NULL, GL_STREAM_READ);
+            readback.busy = false;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
 #endif
 
@@ -357,12 +373,20 @@ int Movie::Movie_EncodeThread(void* arg) {
     return 0;
 }
 
-void Movie::EncodeVideo(bool last) {
-    SDL_ffmpegAddVideoFrame(av->ffmpeg_file, temp_surface, av->video_counter++, last);
+void Movie::EncodeVideo(QueuedFrame* frame) {
+    // no frame means flush the encoder
+    if (!frame)
+        SDL_ffmpegAddVideoFrame(av->ffmpeg_file, NULL, av->video_counter++, true);
+    else if (frame->upside_down)
+        SDL_ffmpegAddUpsideDownVideoFrame(av->ffmpeg_file, frame->surface, av->video_counter++, false);
+    else
+        SDL_ffmpegAddVideoFrame(av->ffmpeg_file, frame->surface, av->video_counter++, false);
 }
 
-void Movie::EncodeAudio(bool last) {
-    av_fifo_generic_write(av->audio_fifo, &audiobuf[0], audiobuf.size(), NULL);
+void Movie::EncodeAudio(QueuedFrame* frame) {
+    bool last = !frame;
+    if (frame)
+        av_fifo_generic_write(av->audio_fifo, &frame->audiobuf[0], frame->audiobuf.size(), NULL);
     auto acodec = av->ffmpeg_file->audioStream->_ctx;
 
     // bps: bytes per sample
@@ -382,20 +406,46 @@ void Movie::EncodeThread() {
     av->audio_counter = 0;
     while (true) {
         SDL_SemWait(encodeReady);
-        if (!stillEncoding) {
-            // signal to quit
+        QueuedFrame& frame = frames[encode_index];
+        encode_index       = (encode_index + 1) % frames.size();
+        if (frame.quit) {
             SDL_SemPost(fillReady);
             return;
         }
 
         // add video and audio
-        EncodeVideo(false);
-        EncodeAudio(false);
+        EncodeVideo(&frame);
+        EncodeAudio(&frame);
 
         SDL_SemPost(fillReady);
     }
 }
 
+// Waits until the encoder has a free frame, and returns its index; frames are
+// handed to the encoder in the order they were claimed
+size_t Movie::ClaimFrame() {
+    SDL_SemWait(fillReady);
+    size_t index = fill_index;
+    fill_index   = (fill_index + 1) % frames.size();
+    return index;
+}
+
+#ifdef HAVE_OPENGL
+void Movie::FinishReadback(PendingReadback& readback) {
+    QueuedFrame& frame = frames[readback.frame];
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    if (const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)) {
+        memcpy(frame.videobuf.data(), pixels, frame.videobuf.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.busy = false;
+    SDL_SemPost(encodeReady);
+}
+#endif
+
 void Movie::AddFrame(FrameType ftype) {
     if (!IsRecording())
         return;
@@ -409,11 +459,14 @@ void Movie::AddFrame(FrameType ftype) {
     if (ftype == FRAME_FADE && get_keyboard_controller_status())
         return;
 
-    SDL_SemWait(fillReady);
+    size_t index       = ClaimFrame();
+    QueuedFrame& frame = frames[index];
+    frame.upside_down  = false;
+    frame.quit         = false;
 
     if (!MainScreenIsOpenGL()) {
         SDL_Surface* video = MainScreenSurface();
-        SDL_BlitSurface(video, &view_rect, temp_surface, NULL);
+        SDL_BlitSurface(video, &view_rect, frame.surface, NULL);
     }
 #ifdef HAVE_OPENGL
     else {
@@ -427,32 +480,52 @@ void Movie::AddFrame(FrameType ftype) {
                              view_rect.h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
         frameBufferObject->deactivate();
 
-        // Read our new frame buffer with rescaled pixels
+        // The oldest read back has had a few frames to complete, so mapping it
+        // won't stall; that also frees its buffer for this frame
+        PendingReadback& readback = readbacks[readback_index];
+        readback_index            = (readback_index + 1) % readbacks.size();
+        if (readback.busy)
+            FinishReadback(readback);
+
+        // Start reading our new frame buffer with rescaled pixels; the rows
+        // come out upside-down, and get flipped when the encoder converts them
         frameBufferObject->activate(true, GL_READ_FRAMEBUFFER_EXT);
-        glReadPixels(view_rect.x, view_rect.y, view_rect.w, view_rect.h, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
-                     &videobuf.front());
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glReadPixels(view_rect.x, view_rect.y, view_rect.w, view_rect.h, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, NULL);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
         frameBufferObject->deactivate();
 
-        // Copy pixel buffer (which is upside-down) to surface
-        for (int y = 0; y < view_rect.h; y++)
-            memcpy((uint8*)temp_surface->pixels + temp_surface->pitch * y,
-                   &videobuf.front() + view_rect.w * 4 * (view_rect.h - y - 1), view_rect.w * 4);
+        readback.frame    = index;
+        readback.busy     = true;
+        frame.upside_down = true;
     }
 #endif
 
-    int bytes     = audiobuf.size();
+    int bytes     = frame.audiobuf.size();
     int frameSize = 2 * in_bps;
     auto oldVol   = OpenALManager::Get()->GetMasterVolume();
     OpenALManager::Get()->SetMasterVolume(SoundManager::From_db(sound_preferences->video_export_volume_db));
-    OpenALManager::Get()->GetPlayBackAudio(&audiobuf.front(), bytes / frameSize);
+    OpenALManager::Get()->GetPlayBackAudio(&frame.audiobuf.front(), bytes / frameSize);
     OpenALManager::Get()->SetMasterVolume(oldVol);
 
-    SDL_SemPost(encodeReady);
+    // OpenGL frames are queued once their read back finishes
+    if (!frame.upside_down)
+        SDL_SemPost(encodeReady);
 }
 
 void Movie::StopRecording() {
     if (encodeThread) {
-        stillEncoding = false;
+#ifdef HAVE_OPENGL
+        // hand over the frames still being read back, oldest first
+        for (size_t i = 0; i < readbacks.size(); ++i) {
+            PendingReadback& readback = readbacks[(readback_index + i) % readbacks.size()];
+            if (readback.busy)
+                FinishReadback(readback);
+        }
+#endif
+
+        // the encoder finishes the queue before it gets to this one
+        frames[ClaimFrame()].quit = true;
         SDL_SemPost(encodeReady);
         SDL_WaitThread(encodeThread, NULL);
         encodeThread = NULL;
@@ -465,14 +538,21 @@ void Movie::StopRecording() {
         SDL_DestroySemaphore(fillReady);
         fillReady = NULL;
     }
-    if (temp_surface) {
-        SDL_FreeSurface(temp_surface);
-        temp_surface = NULL;
+#ifdef HAVE_OPENGL
+    for (auto& readback : readbacks) glDeleteBuffers(1, &readback.buffer);
+    readbacks.clear();
+    readback_index = 0;
+#endif
+    for (auto& frame : frames) {
+        if (frame.surface)
+            SDL_FreeSurface(frame.surface);
     }
+    frames.clear();
+    fill_index = encode_index = 0;
     if (av->inited) {
         // flush video and audio
-        EncodeVideo(true);
-        EncodeAudio(true);
+        EncodeVideo(NULL);
+        EncodeAudio(NULL);
         SDL_ffmpegFree(av->ffmpeg_file);
         av->inited = false;
     }
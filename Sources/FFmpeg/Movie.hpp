@@ -60,10 +60,19 @@ class Movie {
 
     std::string moviefile;
     SDL_Rect view_rect;
-    SDL_Surface* temp_surface;
 
-    std::vector<uint8> videobuf;
-    std::vector<uint8> audiobuf;
+    // Captured frames wait here until the encoder thread gets to them; the
+    // render thread only blocks when every one of them is still queued
+    struct QueuedFrame {
+        std::vector<uint8> videobuf;
+        std::vector<uint8> audiobuf;
+        SDL_Surface* surface; // wraps videobuf
+        bool upside_down;     // read back from OpenGL, bottom row first
+        bool quit;            // no more frames after this one
+    };
+    std::vector<QueuedFrame> frames;
+    size_t fill_index;
+    size_t encode_index;
     int in_bps;
 
     struct libav_vars* av;
@@ -71,18 +80,30 @@ class Movie {
     SDL_Thread* encodeThread;
     SDL_sem* encodeReady;
     SDL_sem* fillReady;
-    bool stillEncoding;
 
 #ifdef HAVE_OPENGL
     std::unique_ptr<FBO> frameBufferObject;
+
+    // Pixel buffers that OpenGL reads frames into asynchronously; each one is
+    // mapped a few frames later, once the transfer has had time to finish
+    struct PendingReadback {
+        GLuint buffer;
+        size_t frame; // queued frame it belongs to
+        bool busy;
+    };
+    std::vector<PendingReadback> readbacks;
+    size_t readback_index;
+
+    void FinishReadback(PendingReadback& readback);
 #endif
 
     Movie();
     bool Setup();
     static int Movie_EncodeThread(void* arg);
     void EncodeThread();
-    void EncodeVideo(bool last);
-    void EncodeAudio(bool last);
+    size_t ClaimFrame();
+    void EncodeVideo(QueuedFrame* frame);
+    void EncodeAudio(QueuedFrame* frame);
     void ThrowUserError(std::string error_msg);
 };
 
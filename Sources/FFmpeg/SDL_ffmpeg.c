@@ -151,6 +151,8 @@ int SDL_ffmpegDecodeAudioFrame( SDL_ffmpegFile*, AVPacket*, SDL_ffmpegAudioFrame
 
 int SDL_ffmpegDecodeVideoFrame( SDL_ffmpegFile*, AVPacket*, SDL_ffmpegVideoFrame* );
 
+static int addVideoFrame( SDL_ffmpegFile*, SDL_Surface*, int, int32_t, int32_t );
+
 SDL_ffmpegFile* SDL_ffmpegCreateFile(void)
 {
     /* create SDL_ffmpegFile pointer */
@@ -524,6 +526,28 @@ SDL_ffmpegFile* SDL_ffmpegCreate( const char* filename )
 \returns    0 if frame was added, non-zero if an error occured.
 */
 int SDL_ffmpegAddVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int32_t frameNumber, int32_t lastFrame )
+{
+    return addVideoFrame( file, sdlFrame, 0, frameNumber, lastFrame );
+}
+
+
+/** \brief  Same as SDL_ffmpegAddVideoFrame, for surfaces stored bottom row first
+
+            The rows are flipped while the frame is converted, so OpenGL read backs
+            don't need to be turned over by the caller.
+\param      file SDL_ffmpegFile to which a frame needs to be added.
+\param      frame SDL_Surface which will be added to the stream.
+\param      frame number
+\param      set to 1 to warn this is the last frame
+\returns    0 if frame was added, non-zero if an error occured.
+*/
+int SDL_ffmpegAddUpsideDownVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int32_t frameNumber, int32_t lastFrame )
+{
+    return addVideoFrame( file, sdlFrame, 1, frameNumber, lastFrame );
+}
+
+
+static int addVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int upsideDown, int32_t frameNumber, int32_t lastFrame )
 {
     /* when accesing audio/video stream, streamMutex should be locked */
     SDL_LockMutex( file->streamMutex );
@@ -539,15 +563,16 @@ int SDL_ffmpegAddVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int32_
     {
         frame = file->videoStream->encodeFrame;
 
+        /* a negative stride makes sws_scale walk the rows bottom up */
         int pitch[] =
         {
-            sdlFrame->pitch,
+            upsideDown ? -sdlFrame->pitch : sdlFrame->pitch,
             0
         };
 
         const uint8_t* const data[] =
         {
-            (uint8_t*)sdlFrame->pixels,
+            (uint8_t*)sdlFrame->pixels + (upsideDown ? sdlFrame->pitch * (sdlFrame->h - 1) : 0),
             0
         };
 
@@ -250,6 +250,8 @@ EXPORT SDL_ffmpegVideoFrame* SDL_ffmpegCreateVideoFrame(void);
 
 EXPORT int SDL_ffmpegAddVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int32_t frameNumber, int32_t lastFrame );
 
+EXPORT int SDL_ffmpegAddUpsideDownVideoFrame( SDL_ffmpegFile *file, SDL_Surface *sdlFrame, int32_t frameNumber, int32_t lastFrame );
+
 EXPORT int SDL_ffmpegGetVideoFrame( SDL_ffmpegFile *file, SDL_ffmpegVideoFrame *frame );
 
 EXPORT void SDL_ffmpegFreeVideoFrame( SDL_ffmpegVideoFrame* frame );
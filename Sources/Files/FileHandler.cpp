@@ -32,6 +32,7 @@
 #endif
 
 #include "FileHandler.hpp"
+#include "LevelPrefetch.hpp"
 #include "cseries.hpp"
 #include "resource_manager.hpp"
 
@@ -623,8 +624,12 @@ static std::string unix_path_separators(const std::string& input) {
 bool FileSpecifier::Open(OpenedFile& OFile, bool Writable) {
     OFile.Close();
 
-    SDL_RWops* f;
-    {
+    // files read ahead for the level being entered come from memory
+    SDL_RWops* f = Writable ? NULL : LevelPrefetch::instance()->open(name);
+    if (f) {
+        OFile.f = f;
+        err     = 0;
+    } else {
 #ifdef HAVE_ZZIP
         if (!Writable) {
             f = OFile.f = SDL_RWFromZZIP(unix_path_separators(GetPath()).c_str(), &utf8_zzip_io());
@@ -0,0 +1,336 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "LevelPrefetch.hpp"
+#include "Logging.hpp"
+#include "cseries.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_set>
+
+// read ahead of what has been opened, at most
+static const size_t kWindowBytes = 256 * MEG;
+
+// files handed to the pool at once
+static const size_t kBatchSize = 16;
+
+// anything bigger is left for its loader to read
+static const int32 kMaxFileBytes = 64 * MEG;
+
+// set on the threads reading ahead, whose own opens must go to the disk
+static thread_local bool reading_ahead = false;
+
+/*
+ *  SDL_RWops over a prefetched file; shares the contents, so it can outlive finish()
+ */
+
+struct prefetched_file {
+    std::shared_ptr<std::vector<uint8>> data;
+    Sint64 position;
+};
+
+static Sint64 prefetched_size(SDL_RWops* context) {
+    prefetched_file* file = static_cast<prefetched_file*>(context->hidden.unknown.data1);
+    return static_cast<Sint64>(file->data->size());
+}
+
+static Sint64 prefetched_seek(SDL_RWops* context, Sint64 offset, int whence) {
+    prefetched_file* file = static_cast<prefetched_file*>(context->hidden.unknown.data1);
+    Sint64 size           = static_cast<Sint64>(file->data->size());
+    Sint64 position;
+    switch (whence) {
+        case RW_SEEK_SET:
+            position = offset;
+            break;
+        case RW_SEEK_CUR:
+            position = file->position + offset;
+            break;
+        case RW_SEEK_END:
+            position = size + offset;
+            break;
+        default:
+            return SDL_SetError("Unknown value for 'whence'");
+    }
+    file->position = std::min(std::max(position, static_cast<Sint64>(0)), size);
+    return file->position;
+}
+
+static size_t prefetched_read(SDL_RWops* context, void* ptr, size_t size, size_t maxnum) {
+    prefetched_file* file = static_cast<prefetched_file*>(context->hidden.unknown.data1);
+    if (!size)
+        return 0;
+
+    size_t available = file->data->size() - static_cast<size_t>(file->position);
+    size_t num       = std::min(maxnum, available / size);
+    memcpy(ptr, file->data->data() + file->position, num * size);
+    file->position += num * size;
+    return num;
+}
+
+static size_t prefetched_write(SDL_RWops* context, const void* ptr, size_t size, size_t num) { return 0; }
+
+static int prefetched_close(SDL_RWops* context) {
+    if (context) {
+        delete static_cast<prefetched_file*>(context->hidden.unknown.data1);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+static SDL_RWops* rwops_from_prefetched(const std::shared_ptr<std::vector<uint8>>& data) {
+    SDL_RWops* ops = SDL_AllocRW();
+    if (ops) {
+        ops->size                 = prefetched_size;
+        ops->seek                 = prefetched_seek;
+        ops->read                 = prefetched_read;
+        ops->write                = prefetched_write;
+        ops->close                = prefetched_close;
+        ops->hidden.unknown.data1 = new prefetched_file{data, 0};
+    }
+    return ops;
+}
+
+static std::shared_ptr<std::vector<uint8>> read_file(const std::string& path) {
+    std::shared_ptr<std::vector<uint8>> data;
+
+    FileSpecifier file = path;
+    OpenedFile opened;
+    int32 length;
+    if (!file.Open(opened) || !opened.GetLength(length) || length > kMaxFileBytes)
+        return data;
+
+    data = std::make_shared<std::vector<uint8>>(length);
+    if (length && !opened.Read(length, data->data()))
+        data.reset();
+    return data;
+}
+
+LevelPrefetch* LevelPrefetch::instance() {
+    static LevelPrefetch* m_instance = nullptr;
+    if (!m_instance) {
+        m_instance = new LevelPrefetch;
+    }
+
+    return m_instance;
+}
+
+void LevelPrefetch::begin(uint32 map_checksum, int16 level_index) {
+    finish();
+
+    m_checksum  = map_checksum;
+    m_level     = level_index;
+    m_has_level = true;
+
+    if (load_manifest()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& path : m_manifest) add(path);
+    }
+
+    if (!m_paths.empty())
+        start();
+}
+
+void LevelPrefetch::prefetch(const std::vector<FileSpecifier>& files) {
+    std::unordered_set<std::string> seen;
+    m_wanted.clear();
+    for (const auto& file : files) {
+        std::string path = file.GetPath();
+        if (!path.empty() && seen.insert(path).second)
+            m_wanted.push_back(path);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& path : m_wanted) add(path);
+    }
+
+    if (m_next < m_paths.size())
+        start();
+}
+
+void LevelPrefetch::finish() {
+    stop();
+
+    if (m_has_level && !m_wanted.empty() && m_wanted != m_manifest)
+        save_manifest();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paths.clear();
+    m_taken.clear();
+    m_positions.clear();
+    m_files.clear();
+    m_next = m_bytes = 0;
+    m_manifest.clear();
+    m_wanted.clear();
+    m_has_level = false;
+}
+
+SDL_RWops* LevelPrefetch::open(const std::string& path) {
+    if (!m_active.load(std::memory_order_relaxed) || reading_ahead)
+        return NULL;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto position = m_positions.find(path);
+    if (position == m_positions.end())
+        return NULL;
+    m_taken[position->second] = true;
+
+    // if the loader has caught up with the reader, it reads this one itself
+    auto it = m_files.find(path);
+    if (it == m_files.end())
+        return NULL;
+
+    SDL_RWops* ops  = rwops_from_prefetched(it->second);
+    m_bytes        -= it->second->size();
+    m_files.erase(it);
+    m_room.notify_one();
+    return ops;
+}
+
+void LevelPrefetch::add(const std::string& path) {
+    if (m_positions.emplace(path, m_paths.size()).second) {
+        m_paths.push_back(path);
+        m_taken.push_back(false);
+    }
+}
+
+void LevelPrefetch::start() {
+    if (!m_pool)
+        m_pool.reset(new WorkerPool(WorkerPool::default_thread_count()));
+
+    m_active = true;
+    if (m_reader.joinable()) {
+        m_room.notify_one();
+        return;
+    }
+
+    m_quit   = false;
+    m_reader = std::thread(&LevelPrefetch::read_loop, this);
+}
+
+void LevelPrefetch::stop() {
+    m_active = false;
+    if (!m_reader.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_room.notify_one();
+    m_reader.join();
+}
+
+void LevelPrefetch::read_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_room.wait(lock, [this] { return m_quit || (m_next < m_paths.size() && m_bytes < kWindowBytes); });
+        if (m_quit)
+            return;
+
+        std::vector<size_t> batch;
+        for (; m_next < m_paths.size() && batch.size() < kBatchSize; ++m_next) {
+            if (!m_taken[m_next])
+                batch.push_back(m_next);
+        }
+
+        std::vector<std::string> paths;
+        for (auto position : batch) paths.push_back(m_paths[position]);
+        lock.unlock();
+
+        std::vector<std::shared_ptr<std::vector<uint8>>> data(batch.size());
+        m_pool->run(static_cast<int>(batch.size()), [&](int i) {
+            reading_ahead = true;
+            data[i]       = read_file(paths[i]);
+            reading_ahead = false;
+        });
+
+        lock.lock();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // files opened while they were being read aren't needed any more
+            if (data[i] && !m_taken[batch[i]]) {
+                m_files[paths[i]]  = data[i];
+                m_bytes           += data[i]->size();
+            }
+        }
+    }
+}
+
+FileSpecifier LevelPrefetch::manifest_file() const {
+    char name[32];
+    snprintf(name, sizeof(name), "%08x-%d.txt", m_checksum, m_level);
+
+    FileSpecifier file;
+    file.SetToImageCacheDir();
+    file.AddPart("Prefetch");
+    file.AddPart(name);
+    return file;
+}
+
+bool LevelPrefetch::load_manifest() {
+    m_manifest.clear();
+
+    FileSpecifier file = manifest_file();
+    OpenedFile opened;
+    int32 length;
+    if (!file.Exists() || !file.Open(opened) || !opened.GetLength(length))
+        return false;
+
+    std::string contents(length, '\0');
+    if (length && !opened.Read(length, &contents[0]))
+        return false;
+
+    size_t start = 0;
+    while (start < contents.size()) {
+        size_t end = contents.find('\n', start);
+        if (end == std::string::npos)
+            end = contents.size();
+        if (end > start)
+            m_manifest.emplace_back(contents, start, end - start);
+        start = end + 1;
+    }
+
+    return !m_manifest.empty();
+}
+
+void LevelPrefetch::save_manifest() {
+    FileSpecifier directory;
+    directory.SetToImageCacheDir();
+    directory.AddPart("Prefetch");
+    directory.CreateDirectory();
+
+    std::string contents;
+    for (const auto& path : m_wanted) {
+        contents += path;
+        contents += '\n';
+    }
+
+    FileSpecifier file = manifest_file();
+    OpenedFile opened;
+    if (!file.Open(opened, true) || !opened.Write(static_cast<int32>(contents.size()), &contents[0]))
+        logWarning("Could not save the prefetch list %s", file.GetPath());
+}
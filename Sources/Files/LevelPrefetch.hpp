@@ -0,0 +1,107 @@
+#ifndef _LEVEL_PREFETCH_
+#define _LEVEL_PREFETCH_
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  Reads the files a level's replacement images come from before they're decoded
+ *
+ *  The renderer lists the files it's about to load with prefetch(); they're read ahead
+ *  on a pool of threads, a window's worth at a time, and FileSpecifier::Open() hands
+ *  out their contents from memory. Files may be opened in any order, from any thread. Each level's list is also saved to the image cache
+ *  directory under the map's checksum, so the next time the level is entered begin()
+ *  can start reading them right away, while the collections and sounds load.
+ */
+
+#include "FileHandler.hpp"
+#include "WorkerPool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class LevelPrefetch {
+  public:
+
+    static LevelPrefetch* instance();
+
+    // Starts reading the files the level needed the last time it was entered
+    void begin(uint32 map_checksum, int16 level_index);
+
+    // Reads the given files, in the order they'll be opened, if they're not being
+    // read already; what begin() started with is replaced by this list next time
+    void prefetch(const std::vector<FileSpecifier>& files);
+
+    // Drops everything read ahead, and saves the list if it changed
+    void finish();
+
+    // The file's contents if they have been read, or NULL; either way they're
+    // handed out only once, as each file is loaded once
+    SDL_RWops* open(const std::string& path);
+
+  private:
+
+    LevelPrefetch() : m_active(false), m_quit(false), m_next(0), m_bytes(0), m_has_level(false) {}
+
+    typedef std::shared_ptr<std::vector<uint8>> file_data;
+
+    void start();
+    void stop();
+    void read_loop();
+    void add(const std::string& path);
+
+    FileSpecifier manifest_file() const;
+    bool load_manifest();
+    void save_manifest();
+
+    std::atomic<bool> m_active;
+
+    std::thread m_reader;
+    std::unique_ptr<WorkerPool> m_pool;
+    std::mutex m_mutex;
+    std::condition_variable m_room; // signaled when read-ahead files are dropped
+    bool m_quit;
+
+    std::vector<std::string> m_paths; // in the order they're opened
+    std::vector<bool> m_taken;        // opened, so not worth reading or keeping
+    std::unordered_map<std::string, size_t> m_positions;
+    size_t m_next; // first path not yet handed to the reader
+    std::unordered_map<std::string, file_data> m_files;
+    size_t m_bytes; // held in m_files
+
+    uint32 m_checksum;
+    int16 m_level;
+    std::vector<std::string> m_manifest; // as loaded, or empty
+    std::vector<std::string> m_wanted;   // given to prefetch()
+    bool m_has_level;                    // whether begin() named the level to save a list for
+};
+
+#endif
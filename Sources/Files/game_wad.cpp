@@ -29,6 +29,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "FileHandler.hpp"
 #include "effects.hpp"
 #include "flood_map.hpp"
@@ -46,6 +51,7 @@
 #include "weapons.hpp"
 
 #include "Plugins.hpp"
+#include "SlotAllocator.hpp"
 #include "SoundManager.hpp"
 #include "computer_interface.hpp" // for loading/saving terminal state.
 #include "editor.hpp"
@@ -55,6 +61,7 @@
 #include "game_window.hpp"
 #include "images.hpp"
 #include "interface.hpp"
+#include "polygon_grid.hpp"
 #include "preferences.hpp"
 #include "shell.hpp"
 #include "tags.hpp"
@@ -779,6 +786,9 @@ void allocate_map_for_counts(size_t polygon_count, size_t side_count, size_t end
     // Stuff that needs the max number of polygons
     allocate_render_memory();
     allocate_flood_map_memory();
+
+    // The old level's grid is no use; entering_map() builds the new one
+    clear_polygon_grid();
 }
 
 void load_points(uint8* points, size_t count) {
@@ -1077,6 +1087,9 @@ bool revert_game(void) {
 
     assert(dynamic_world->player_count == 1);
 
+    // the game to revert to may still be on its way to disk
+    finish_saved_games(true);
+
     leaving_map();
 
     if (revert_game_data.game_is_from_disk) {
@@ -1183,15 +1196,8 @@ bool export_level(FileSpecifier& File) {
 
 void get_current_saved_game_name(FileSpecifier& File) { File = revert_game_data.SavedGame; }
 
-/* The current mapfile should be set to the save game file... */
-bool save_game_file(FileSpecifier& File, const std::string& metadata, const std::string& imagedata) {
-    struct wad_header header;
-    short err    = 0;
-    bool success = false;
-    int32 offset, wad_length;
-    struct directory_entry entries[2];
-    struct wad_data *wad, *meta_wad;
-
+/* Packs the world to be saved to File; this is the part that has to run on the main thread */
+static struct wad_data* build_saved_game(FileSpecifier& File, struct wad_header* header, int32* length) {
     /* Save off the random seed. */
     dynamic_world->random_seed = get_random_seed();
 
@@ -1199,56 +1205,62 @@ bool save_game_file(FileSpecifier& File, const std::string& metadata, const std:
     revert_game_data.game_is_from_disk = true;
     revert_game_data.SavedGame         = File;
 
+    /* Fill in the default wad header (we are using File instead of TempFile to get the name right in the header) */
+    fill_default_wad_header(File, CURRENT_WADFILE_VERSION, EDITOR_MAP_VERSION, 2, 0, header);
+    header->parent_checksum = read_wad_file_checksum(MapFileSpec);
+
+    return build_save_game_wad(header, length);
+}
+
+/* Writes a packed world and its metadata to File, from any thread, and frees the wad */
+static bool write_saved_game(FileSpecifier& File, struct wad_header* header, struct wad_data* wad, int32 wad_length,
+                             const std::string& metadata, const std::string& imagedata, short* error) {
+    short err    = 0;
+    bool success = false;
+    int32 offset, meta_wad_length;
+    struct directory_entry entries[2];
+    struct wad_data* meta_wad;
+
     // LP: add a file here; use temporary file for a safe save.
     // Write into the temporary file first
     FileSpecifier TempFile;
     TempFile.SetTempName(File);
 
-    /* Fill in the default wad header (we are using File instead of TempFile to get the name right in the header) */
-    fill_default_wad_header(File, CURRENT_WADFILE_VERSION, EDITOR_MAP_VERSION, 2, 0, &header);
-
     /* Assume that we confirmed on save as... */
     if (create_wadfile(TempFile, _typecode_savegame)) {
         OpenedFile SaveFile;
         if (open_wad_file_for_writing(TempFile, SaveFile)) {
             /* Write out the new header */
-            if (write_wad_header(SaveFile, &header)) {
+            if (write_wad_header(SaveFile, header)) {
                 offset = SIZEOF_wad_header;
 
-                wad = build_save_game_wad(&header, &wad_length);
-                if (wad) {
-                    /* Set the entry data.. */
-                    set_indexed_directory_offset_and_length(&header, entries, 0, offset, wad_length, 0);
+                /* Set the entry data.. */
+                set_indexed_directory_offset_and_length(header, entries, 0, offset, wad_length, 0);
 
-                    /* Save it.. */
-                    if (write_wad(SaveFile, &header, wad, offset)) {
-                        /* Update the new header */
-                        offset                  += wad_length;
-                        header.directory_offset  = offset;
-                        header.parent_checksum   = read_wad_file_checksum(MapFileSpec);
-
-                        /* Create metadata wad */
-                        meta_wad = build_meta_game_wad(metadata, imagedata, &header, &wad_length);
-                        if (meta_wad) {
-                            set_indexed_directory_offset_and_length(&header, entries, 1, offset, wad_length,
-                                                                    SAVE_GAME_METADATA_INDEX);
-
-                            if (write_wad(SaveFile, &header, meta_wad, offset)) {
-                                offset                  += wad_length;
-                                header.directory_offset  = offset;
-
-                                if (write_wad_header(SaveFile, &header)
-                                    && write_directorys(SaveFile, &header, entries)) {
-                                    /* We win. */
-                                    success = true;
-                                }
-                            }
+                /* Save it.. */
+                if (write_wad(SaveFile, header, wad, offset)) {
+                    /* Update the new header */
+                    offset                   += wad_length;
+                    header->directory_offset  = offset;
+
+                    /* Create metadata wad */
+                    meta_wad = build_meta_game_wad(metadata, imagedata, header, &meta_wad_length);
+                    if (meta_wad) {
+                        set_indexed_directory_offset_and_length(header, entries, 1, offset, meta_wad_length,
+                                                                SAVE_GAME_METADATA_INDEX);
+
+                        if (write_wad(SaveFile, header, meta_wad, offset)) {
+                            offset                   += meta_wad_length;
+                            header->directory_offset  = offset;
 
-                            free_wad(meta_wad);
+                            if (write_wad_header(SaveFile, header) && write_directorys(SaveFile, header, entries)) {
+                                /* We win. */
+                                success = true;
+                            }
                         }
-                    }
 
-                    free_wad(wad);
+                        free_wad(meta_wad);
+                    }
                 }
             }
 
@@ -1262,18 +1274,103 @@ bool save_game_file(FileSpecifier& File, const std::string& metadata, const std:
             }
         }
     }
+    free_wad(wad);
 
     if (err || error_pending()) {
         if (!err)
             err = get_game_error(NULL);
-        alert_user(infoError, strERRORS, fileError, err);
         clear_game_error();
         success = false;
     }
 
+    *error = err;
     return success;
 }
 
+struct background_save {
+    FileSpecifier file;
+    struct wad_header header;
+    struct wad_data* wad;
+    int32 wad_length;
+    std::string metadata;
+    std::function<std::string()> imagedata;
+    std::function<void(bool)> saved;
+    bool success;
+    short error;
+};
+
+// Saves are written one at a time, in order, by a thread that runs while there are any to write
+static std::mutex background_saves_mutex;
+static std::condition_variable background_saves_changed;
+static std::deque<background_save> queued_saves;
+static std::vector<background_save> written_saves;
+static bool background_saver_running = false;
+
+static void write_background_saves() {
+    std::unique_lock<std::mutex> lock(background_saves_mutex);
+    while (!queued_saves.empty()) {
+        // nothing else touches the save at the front until it is written
+        background_save& save = queued_saves.front();
+        lock.unlock();
+
+        save.success = write_saved_game(save.file, &save.header, save.wad, save.wad_length, save.metadata,
+                                        save.imagedata ? save.imagedata() : std::string(), &save.error);
+
+        lock.lock();
+        written_saves.push_back(std::move(save));
+        queued_saves.pop_front();
+        background_saves_changed.notify_all();
+    }
+    background_saver_running = false;
+    background_saves_changed.notify_all();
+}
+
+bool save_game_file_in_background(FileSpecifier& File, const std::string& metadata,
+                                  std::function<std::string()> imagedata, std::function<void(bool)> saved) {
+    background_save save;
+    save.wad = build_saved_game(File, &save.header, &save.wad_length);
+    if (!save.wad) {
+        if (error_pending()) {
+            alert_user(infoError, strERRORS, fileError, get_game_error(NULL));
+            clear_game_error();
+        }
+        return false;
+    }
+
+    save.file      = File;
+    save.metadata  = metadata;
+    save.imagedata = std::move(imagedata);
+    save.saved     = std::move(saved);
+    save.success   = false;
+    save.error     = 0;
+
+    std::lock_guard<std::mutex> lock(background_saves_mutex);
+    queued_saves.push_back(std::move(save));
+    if (!background_saver_running) {
+        background_saver_running = true;
+        std::thread(write_background_saves).detach();
+    }
+
+    return true;
+}
+
+void finish_saved_games(bool wait) {
+    std::vector<background_save> written;
+    {
+        std::unique_lock<std::mutex> lock(background_saves_mutex);
+        if (wait)
+            background_saves_changed.wait(lock, [] { return !background_saver_running; });
+        written.swap(written_saves);
+    }
+
+    for (auto& save : written) {
+        if (save.error)
+            alert_user(infoError, strERRORS, fileError, save.error);
+        if (save.saved)
+            save.saved(save.success);
+    }
+}
+
 /* -------- static functions */
 static void scan_and_add_platforms(uint8* platform_static_data, size_t count, short version) {
     struct polygon_data* polygon;
@@ -1628,6 +1725,9 @@ bool process_map_wad(struct wad_data* wad, bool restoring_game, short version) {
                 csprintf(temporary, "Number of projectiles %zu > limit %u", count, MAXIMUM_PROJECTILES_PER_MAP));
         unpack_projectile_data(data, projectiles, count);
 
+        // the slots they left free are the ones to hand out next
+        invalidate_slot_allocators();
+
         data  = (uint8*)extract_type_from_wad(wad, PLATFORM_STRUCTURE_TAG, &data_length);
         count = data_length / SIZEOF_platform_data;
         assert(count * SIZEOF_platform_data == data_length);
@@ -27,11 +27,17 @@
 
 #include "cstypes.hpp"
 #include "map.hpp"
+#include <functional>
 #include <string>
 
 class FileSpecifier;
 
-bool save_game_file(FileSpecifier& File, const std::string& metadata, const std::string& imagedata);
+// Packs the world right away and writes it to File on a background thread, where
+// imagedata is also called; saved is called from finish_saved_games once it's written
+bool save_game_file_in_background(FileSpecifier& File, const std::string& metadata,
+                                  std::function<std::string()> imagedata, std::function<void(bool)> saved);
+// Calls back the saves that have been written, first waiting for all of them if wait is set
+void finish_saved_games(bool wait = false);
 struct wad_data* build_meta_game_wad(const std::string& metadata, const std::string& imagedata,
                                      struct wad_header* header, int32* length);
 
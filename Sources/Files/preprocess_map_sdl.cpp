@@ -111,10 +111,9 @@ bool choose_saved_game_to_load(FileSpecifier& saved_game) { return load_quick_sa
  */
 
 bool save_game(void) {
+    // QuickSaves reports how it went once the game is written
     bool success = create_quick_save();
-    if (success)
-        screen_printf("Game saved");
-    else
+    if (!success)
         screen_printf("Save failed");
 
     return success;
@@ -0,0 +1,133 @@
+#ifndef _SLOT_ALLOCATOR_
+#define _SLOT_ALLOCATOR_
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  Finds the lowest free slot of a world array (objects, projectiles, effects) without
+ *  scanning it, so slots are handed out in exactly the order the old scans did
+ *
+ *  A bit per free slot, and a bit per 64 of those saying any of them is set, find the
+ *  lowest free slot in a handful of word tests even at the 32767 slot limit. The slots'
+ *  own used flags stay the truth: whatever rewrites them wholesale (a new level, a
+ *  restored game, a rolled back prediction, new dynamic limits) calls
+ *  invalidate_slot_allocators(), and every allocator reads them again before its next
+ *  find_free().
+ */
+
+#include "map.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+inline uint32& slot_allocator_epoch() {
+    static uint32 epoch = 0;
+    return epoch;
+}
+
+inline void invalidate_slot_allocators() { ++slot_allocator_epoch(); }
+
+template <class T>
+class SlotAllocator {
+  public:
+
+    explicit SlotAllocator(const std::vector<T>& slots) : _slots(slots), _count(0), _epoch(0), _synced(false) {}
+
+    // The lowest free slot, or NONE if all of them are used
+    short find_free() {
+        sync();
+
+        for (size_t group = 0; group < _groups.size(); ++group) {
+            if (_groups[group]) {
+                size_t word = group * 64 + lowest_bit(_groups[group]);
+                return static_cast<short>(word * 64 + lowest_bit(_free[word]));
+            }
+        }
+
+        return NONE;
+    }
+
+    // Call along with MARK_SLOT_AS_USED() and MARK_SLOT_AS_FREE()
+    void mark_used(short index) {
+        if (synced()) {
+            size_t word   = index >> 6;
+            _free[word]  &= ~(uint64_t(1) << (index & 63));
+            if (!_free[word])
+                _groups[word >> 6] &= ~(uint64_t(1) << (word & 63));
+        }
+    }
+
+    void mark_free(short index) {
+        if (synced()) {
+            size_t word         = index >> 6;
+            _free[word]        |= uint64_t(1) << (index & 63);
+            _groups[word >> 6] |= uint64_t(1) << (word & 63);
+        }
+    }
+
+  private:
+
+    bool synced() const { return _synced && _epoch == slot_allocator_epoch() && _count == _slots.size(); }
+
+    void sync() {
+        if (synced())
+            return;
+
+        _count = _slots.size();
+        _free.assign((_count + 63) / 64, 0);
+        _groups.assign((_free.size() + 63) / 64, 0);
+        _epoch  = slot_allocator_epoch();
+        _synced = true;
+
+        for (size_t index = 0; index < _count; ++index) {
+            if (SLOT_IS_FREE(&_slots[index]))
+                mark_free(static_cast<short>(index));
+        }
+    }
+
+    static int lowest_bit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#else
+        int bit = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    const std::vector<T>& _slots;
+    size_t _count;
+    uint32 _epoch;
+    bool _synced;
+
+    std::vector<uint64_t> _free;   // a set bit for each free slot
+    std::vector<uint64_t> _groups; // a set bit for each word of _free with any bit set
+};
+
+#endif
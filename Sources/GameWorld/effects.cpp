@@ -23,6 +23,7 @@
  */
 
 #include "effects.hpp"
+#include "SlotAllocator.hpp"
 #include "SoundManager.hpp"
 #include "cseries.hpp"
 #include "interface.hpp"
@@ -43,6 +44,8 @@ ryan reports get_object_data() failing on effect->data after a teleport effect t
 
 /* ---------- globals */
 
+static SlotAllocator<effect_data> EffectSlots(EffectList);
+
 /* import effect definition constants, structures and globals */
 #include "effect_definitions.hpp"
 
@@ -88,37 +91,35 @@ short new_effect(world_point3d* origin, short polygon_index, short type, angle f
 
             play_world_sound(polygon_index, origin, animation->first_frame_sound);
         } else {
-            for (effect_index = 0, effect = effects; effect_index < MAXIMUM_EFFECTS_PER_MAP; ++effect_index, ++effect) {
-                if (SLOT_IS_FREE(effect)) {
-                    short object_index = new_map_object3d(
-                            origin, polygon_index, BUILD_DESCRIPTOR(definition->collection, definition->shape), facing);
-
-                    if (object_index != NONE) {
-                        struct object_data* object = get_object_data(object_index);
-
-                        effect->type         = type;
-                        effect->flags        = 0;
-                        effect->object_index = object_index;
-                        effect->data         = NONE;
-                        effect->delay        = definition->delay ? global_random() % definition->delay : 0;
-                        MARK_SLOT_AS_USED(effect);
-
-                        SET_OBJECT_OWNER(object, _object_is_effect);
-                        object->permutation = effect_index;
-                        object->sound_pitch = definition->sound_pitch;
-                        if (effect->delay)
-                            SET_OBJECT_INVISIBILITY(object, true);
-                        if (definition->flags & _media_effect)
-                            SET_OBJECT_IS_MEDIA_EFFECT(object);
-                    } else {
-                        effect_index = NONE;
-                    }
-
-                    break;
+            effect_index = EffectSlots.find_free();
+            if (effect_index != NONE) {
+                effect = effects + effect_index;
+
+                short object_index = new_map_object3d(
+                        origin, polygon_index, BUILD_DESCRIPTOR(definition->collection, definition->shape), facing);
+
+                if (object_index != NONE) {
+                    struct object_data* object = get_object_data(object_index);
+
+                    effect->type         = type;
+                    effect->flags        = 0;
+                    effect->object_index = object_index;
+                    effect->data         = NONE;
+                    effect->delay        = definition->delay ? global_random() % definition->delay : 0;
+                    MARK_SLOT_AS_USED(effect);
+                    EffectSlots.mark_used(effect_index);
+
+                    SET_OBJECT_OWNER(object, _object_is_effect);
+                    object->permutation = effect_index;
+                    object->sound_pitch = definition->sound_pitch;
+                    if (effect->delay)
+                        SET_OBJECT_INVISIBILITY(object, true);
+                    if (definition->flags & _media_effect)
+                        SET_OBJECT_IS_MEDIA_EFFECT(object);
+                } else {
+                    effect_index = NONE;
                 }
             }
-            if (effect_index == MAXIMUM_EFFECTS_PER_MAP)
-                effect_index = NONE;
         }
     }
 
@@ -174,6 +175,7 @@ void remove_effect(short effect_index) {
     remove_map_object(effect->object_index);
     L_Invalidate_Effect(effect_index);
     MARK_SLOT_AS_FREE(effect);
+    EffectSlots.mark_free(effect_index);
 }
 
 void remove_all_nonpersistent_effects(void) {
@@ -69,13 +69,39 @@ using namespace alephbet::flood_map;
 
 /* ---------- globals */
 
-static short node_count = 0, last_node_index_expanded = NONE;
-static struct node_data* nodes = NULL;
-static short* visited_polygons = NULL;
+/* every thread has a flood of its own, so monsters can look for targets in parallel; threads other
+    than the main one allocate theirs the first time they flood (and keep it until they exit) */
+static thread_local short node_count = 0, last_node_index_expanded = NONE;
+static thread_local struct node_data* nodes = NULL;
+
+/* where flood_map() picks up again; unlike last_node_index_expanded this is not disturbed by
+    reverse_flood_map() and friends, so a finished path search can be resumed later */
+static thread_local short last_node_index_flooded = NONE;
+static thread_local uint32 flood_serial           = 0;
+
+/* visited_polygons[i] is only meaningful when visited_generations[i]==flood_generation; bumping
+    the generation forgets every polygon at once instead of clearing the whole array per flood */
+static thread_local short* visited_polygons     = NULL;
+static thread_local uint16* visited_generations = NULL;
+static thread_local uint16 flood_generation     = 0;
+static thread_local size_t visited_capacity     = 0;
+
+/* unexpanded nodes for _best_first, as a binary heap ordered by (cost, node index) so it always
+    yields the same node the old linear scan over the node list did */
+static thread_local bool frontier_is_heap = false;
+static thread_local short frontier_count  = 0;
+static thread_local short frontier[MAXIMUM_FLOOD_NODES];
+static thread_local short frontier_positions[MAXIMUM_FLOOD_NODES];
 
 /* ---------- private prototypes */
 
 static void add_node(short parent_node_index, short polygon_index, short depth, int32 cost, int32 user_flags);
+static short visited_node_index(short polygon_index);
+
+static void push_frontier(short node_index);
+static short pop_frontier(void);
+static void sift_frontier_up(short position);
+static void sift_frontier_down(short position);
 
 /* ---------- code */
 
@@ -87,6 +113,12 @@ void allocate_flood_map_memory(void) {
     if (visited_polygons)
         delete[] visited_polygons;
     visited_polygons = new short[MAXIMUM_POLYGONS_PER_MAP];
+    if (visited_generations)
+        delete[] visited_generations;
+    visited_generations = new uint16[MAXIMUM_POLYGONS_PER_MAP];
+    objlist_clear(visited_generations, MAXIMUM_POLYGONS_PER_MAP);
+    flood_generation = 0;
+    visited_capacity = MAXIMUM_POLYGONS_PER_MAP;
 }
 
 /* returns next polygon index or NONE if there are no more polygons left cheaper than maximum_cost */
@@ -99,30 +131,41 @@ short flood_map(short first_polygon_index, int32 maximum_cost, cost_proc_ptr cos
 
     /* initialize ourselves if first_polygon_index!=NONE */
     if (first_polygon_index != NONE) {
-        /* clear the visited polygon array */
-        objlist_set(visited_polygons, NONE, MAXIMUM_POLYGONS_PER_MAP);
+        if (visited_capacity < MAXIMUM_POLYGONS_PER_MAP)
+            allocate_flood_map_memory();
+
+        /* forget the visited polygons; only clear the array when the generation wraps */
+        if (++flood_generation == 0) {
+            objlist_clear(visited_generations, MAXIMUM_POLYGONS_PER_MAP);
+            flood_generation = 1;
+        }
 
         node_count               = 0;
         last_node_index_expanded = NONE;
+        last_node_index_flooded  = NONE;
+        flood_serial            += 1;
+        frontier_is_heap         = flood_mode == _best_first;
+        frontier_count           = 0;
         add_node(NONE, first_polygon_index, 0, 0, (flood_mode == _flagged_breadth_first) ? *((int32*)caller_data) : 0);
     }
 
     switch (flood_mode) {
         case _best_first:
-            /* find the unexpanded node with the lowest cost */
-            lowest_cost = maximum_cost, lowest_cost_node_index = NONE;
-            for (node = nodes, node_index = 0; node_index < node_count; ++node_index, ++node) {
-                if (NODE_IS_UNEXPANDED(node) && node->cost < lowest_cost) {
-                    lowest_cost_node_index = node_index;
-                    lowest_cost            = node->cost;
-                }
+            /* take the unexpanded node with the lowest cost (ties going to the lowest node index) */
+            assert(frontier_is_heap);
+            if (frontier_count > 0 && nodes[frontier[0]].cost < maximum_cost) {
+                lowest_cost_node_index = pop_frontier();
+                lowest_cost            = nodes[lowest_cost_node_index].cost;
+            } else {
+                lowest_cost_node_index = NONE;
+                lowest_cost            = maximum_cost;
             }
             break;
 
         case _breadth_first:
         case _flagged_breadth_first:
             /* find the next unexpanded node in the list under maximum_cost */
-            node_index = (last_node_index_expanded == NONE) ? 0 : (last_node_index_expanded + 1);
+            node_index = (last_node_index_flooded == NONE) ? 0 : (last_node_index_flooded + 1);
             for (node = nodes + node_index; node_index < node_count; ++node_index, ++node) {
                 if (node->cost < maximum_cost)
                     break;
@@ -152,7 +195,7 @@ short flood_map(short first_polygon_index, int32 maximum_cost, cost_proc_ptr cos
         short i;
 
         /* for flood_depth() and reverse_flood_map(), remember which node we successfully expanded last */
-        last_node_index_expanded = lowest_cost_node_index;
+        last_node_index_expanded = last_node_index_flooded = lowest_cost_node_index;
 
         /* get pointer to lowest cost node */
         assert(lowest_cost_node_index >= 0 && lowest_cost_node_index < node_count);
@@ -168,7 +211,7 @@ short flood_map(short first_polygon_index, int32 maximum_cost, cost_proc_ptr cos
             short destination_polygon_index = polygon->adjacent_polygon_indexes[i];
 
             if (destination_polygon_index != NONE
-                && (maximum_cost != INT32_MAX || visited_polygons[destination_polygon_index] == UNVISITED)) {
+                && (maximum_cost != INT32_MAX || visited_node_index(destination_polygon_index) == UNVISITED)) {
                 int32 new_user_flags = node->user_flags;
                 int32 cost
                         = cost_proc
@@ -187,12 +230,29 @@ short flood_map(short first_polygon_index, int32 maximum_cost, cost_proc_ptr cos
         if (flood_mode == _flagged_breadth_first)
             *((int32*)caller_data) = node->user_flags;
     } else {
-        polygon_index = NONE;
+        /* a resumed flood that has run dry still ends at the last node it expanded */
+        last_node_index_expanded = last_node_index_flooded;
+        polygon_index            = NONE;
     }
 
     return polygon_index;
 }
 
+/* identifies the flood in progress; this changes every time flood_map() starts a new one */
+uint32 current_flood_map(void) { return flood_serial; }
+
+/* if the current flood has already expanded the given polygon, make it the last node expanded (so
+    flood_depth() and reverse_flood_map() work as if flood_map() had just returned it) */
+bool rewind_flood_map(short polygon_index) {
+    short node_index = visited_node_index(polygon_index);
+
+    if (node_index == UNVISITED || NODE_IS_UNEXPANDED(nodes + node_index))
+        return false;
+
+    last_node_index_expanded = node_index;
+    return true;
+}
+
 /* walks backwards from the last node expanded, returning polygons as it goes; returns NONE
     when there are no more polygons to return.  this is useful for pathfinding: when
     flood_map() returns the destination polygon index, calling reverse_flood_map() will return
@@ -265,7 +325,7 @@ static void add_node(short parent_node_index, short polygon_index, short depth,
 
         /* see if this polygon already exists in the node list anywhere */
         assert(polygon_index >= 0 && polygon_index < dynamic_world->polygon_count);
-        if ((node_index = visited_polygons[polygon_index]) != UNVISITED) {
+        if ((node_index = visited_node_index(polygon_index)) != UNVISITED) {
             /* there is already a node referencing this polygon; if it has a higher cost
                 than the cost we are attempting to add, replace it (because we are doing
                 a best-first search, we are guarenteed never to find a better path to an
@@ -281,7 +341,8 @@ static void add_node(short parent_node_index, short polygon_index, short depth,
         }
 
         if (node) {
-            if (node_index == node_count) {
+            bool is_new_node = node_index == node_count;
+            if (is_new_node) {
                 node_count += 1;
             }
 
@@ -293,10 +354,81 @@ static void add_node(short parent_node_index, short polygon_index, short depth,
             node->user_flags        = user_flags;
 
             assert(polygon_index >= 0 && polygon_index < dynamic_world->polygon_count);
-            visited_polygons[polygon_index] = node_index;
+            visited_polygons[polygon_index]    = node_index;
+            visited_generations[polygon_index] = flood_generation;
+
+            /* a replaced node is still unexpanded (and so still in the frontier), only cheaper */
+            if (frontier_is_heap) {
+                if (is_new_node)
+                    push_frontier(node_index);
+                else
+                    sift_frontier_up(frontier_positions[node_index]);
+            }
 
             //			dprintf("added polygon #%d to node #%d (nodes=%p,visited=%p)", polygon_index, node_index, nodes,
             //visited_polygons);
         }
     }
 }
+
+static short visited_node_index(short polygon_index) {
+    return visited_generations[polygon_index] == flood_generation ? visited_polygons[polygon_index] : UNVISITED;
+}
+
+/* the old linear scan kept the first of several equally cheap nodes, so ties go to the lower index */
+static bool frontier_precedes(short a, short b) {
+    return nodes[a].cost < nodes[b].cost || (nodes[a].cost == nodes[b].cost && a < b);
+}
+
+static void place_in_frontier(short node_index, short position) {
+    frontier[position]             = node_index;
+    frontier_positions[node_index] = position;
+}
+
+static void push_frontier(short node_index) {
+    assert(frontier_count < MAXIMUM_FLOOD_NODES);
+    place_in_frontier(node_index, frontier_count);
+    sift_frontier_up(frontier_count++);
+}
+
+static short pop_frontier(void) {
+    short node_index = frontier[0];
+
+    assert(frontier_count > 0);
+    if (--frontier_count > 0) {
+        place_in_frontier(frontier[frontier_count], 0);
+        sift_frontier_down(0);
+    }
+
+    return node_index;
+}
+
+static void sift_frontier_up(short position) {
+    short node_index = frontier[position];
+
+    while (position > 0) {
+        short parent = (position - 1) / 2;
+        if (!frontier_precedes(node_index, frontier[parent]))
+            break;
+        place_in_frontier(frontier[parent], position);
+        position = parent;
+    }
+    place_in_frontier(node_index, position);
+}
+
+static void sift_frontier_down(short position) {
+    short node_index = frontier[position];
+
+    for (;;) {
+        short child = 2 * position + 1;
+        if (child >= frontier_count)
+            break;
+        if (child + 1 < frontier_count && frontier_precedes(frontier[child + 1], frontier[child]))
+            child += 1;
+        if (!frontier_precedes(frontier[child], node_index))
+            break;
+        place_in_frontier(frontier[child], position);
+        position = child;
+    }
+    place_in_frontier(node_index, position);
+}
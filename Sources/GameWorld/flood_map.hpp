@@ -46,12 +46,19 @@ typedef int32 (*cost_proc_ptr)(short source_polygon_index, short line_index, sho
 
 void allocate_pathfinding_memory(void);
 void reset_paths(void);
+void invalidate_shared_path_flood(void);
 
+/* paths with the same shared_flood_key (NONE for none) leaving the same polygon reuse one flood until
+    invalidate_shared_path_flood() is called; the key must pin down everything cost reads from data */
 short new_path(world_point2d* source_point, short source_polygon_index, world_point2d* destination_point,
-               short destination_polygon_index, world_distance minimum_separation, cost_proc_ptr cost, void* data);
+               short destination_polygon_index, world_distance minimum_separation, cost_proc_ptr cost, void* data,
+               int32 shared_flood_key);
 bool move_along_path(short path_index, world_point2d* p);
 void delete_path(short path_index);
 
+/* the path table, for world snapshots */
+void* get_path_storage(size_t* size);
+
 /* ---------- prototypes/FLOOD_MAP.C */
 
 void allocate_flood_map_memory(void);
@@ -65,4 +72,7 @@ short flood_depth(void);
 
 void choose_random_flood_node(world_vector2d* bias);
 
+uint32 current_flood_map(void);
+bool rewind_flood_map(short polygon_index);
+
 #endif
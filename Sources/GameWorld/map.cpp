@@ -33,6 +33,7 @@ find_line_crossed leaving polygon could be sped up considerable by reversing the
 #include "Console.hpp"
 #include "FilmProfile.hpp"
 #include "InfoTree.hpp"
+#include "SlotAllocator.hpp"
 #include "SoundManager.hpp"
 #include "cseries.hpp"
 #include "effects.hpp"
@@ -44,6 +45,7 @@ find_line_crossed leaving polygon could be sped up considerable by reversing the
 #include "monsters.hpp"
 #include "platforms.hpp"
 #include "player.hpp"
+#include "polygon_grid.hpp"
 #include "preferences.hpp"
 #include "projectiles.hpp"
 #include "scenery.hpp"
@@ -115,6 +117,8 @@ vector<effect_data> EffectList(MAXIMUM_EFFECTS_PER_MAP);
 vector<object_data> ObjectList(MAXIMUM_OBJECTS_PER_MAP);
 vector<monster_data> MonsterList(MAXIMUM_MONSTERS_PER_MAP);
 vector<projectile_data> ProjectileList(MAXIMUM_PROJECTILES_PER_MAP);
+
+static SlotAllocator<object_data> ObjectSlots(ObjectList);
 // struct object_data *objects = NULL;
 // struct monster_data *monsters = NULL;
 // struct projectile_data *projectiles = NULL;
@@ -332,6 +336,8 @@ void initialize_map_for_new_level(void) {
     objlist_clear(monsters, MonsterList.size());
     objlist_clear(objects, ObjectList.size());
 
+    invalidate_slot_allocators();
+
     /* Note that these pointers just point into a larger structure, so this is not a bad thing */
     // map_polygons= NULL;
     // map_sides= NULL;
@@ -529,6 +535,8 @@ void reconnect_map_object_list(void) {
             polygon->first_object = i;
         }
     }
+
+    invalidate_shared_path_flood();
 }
 
 bool valid_point2d(world_point2d* p) { return world_point_to_polygon_index(p) == NONE ? false : true; }
@@ -592,6 +600,7 @@ short new_map_object3d(world_point3d* location, short polygon_index, shape_descr
         /* insert at head of linked list */
         object->next_object   = polygon->first_object;
         polygon->first_object = object_index;
+        invalidate_shared_path_flood();
     }
 
     return object_index;
@@ -642,6 +651,7 @@ void remove_parasitic_object(short host_index) {
     struct object_data* host     = get_object_data(host_index);
     struct object_data* parasite = get_object_data(host->parasitic_object);
 
+    ObjectSlots.mark_free(host->parasitic_object);
     host->parasitic_object = NONE;
     MARK_SLOT_AS_FREE(parasite);
 }
@@ -659,11 +669,14 @@ void remove_map_object(short object_index) {
         struct object_data* parasite = get_object_data(object->parasitic_object);
 
         MARK_SLOT_AS_FREE(parasite);
+        ObjectSlots.mark_free(object->parasitic_object);
     }
 
     L_Invalidate_Object(object_index);
     *next_object = object->next_object;
     MARK_SLOT_AS_FREE(object);
+    ObjectSlots.mark_free(object_index);
+    invalidate_shared_path_flood();
 }
 
 /* remove the object from the old_polygon’s object list*/
@@ -683,6 +696,7 @@ void remove_object_from_polygon_object_list(short object_index, short polygon_in
     *next_object = object->next_object;
 
     object->polygon = NONE;
+    invalidate_shared_path_flood();
 }
 
 void remove_object_from_polygon_object_list(short object_index) {
@@ -698,6 +712,7 @@ void add_object_to_polygon_object_list(short object_index, short polygon_index)
     polygon->first_object = object_index;
 
     object->polygon = polygon_index;
+    invalidate_shared_path_flood();
 }
 
 typedef std::pair<short, short> DeferredObjectListInsertion;
@@ -1162,6 +1177,19 @@ short clockwise_endpoint_in_line(short polygon_index, short line_index, short in
 short world_point_to_polygon_index(world_point2d* location) {
     short polygon_index;
     struct polygon_data* polygon;
+    const int16_t* candidates;
+    size_t candidate_count;
+
+    /* the grid hands back every polygon that could contain the point, lowest index first, so this
+        finds the same polygon as the full walk below */
+    if (get_polygon_grid_candidates(*location, candidates, candidate_count)) {
+        for (size_t i = 0; i < candidate_count; ++i) {
+            polygon_index = candidates[i];
+            if (!POLYGON_IS_DETACHED(get_polygon_data(polygon_index)) && point_in_polygon(polygon_index, location))
+                return polygon_index;
+        }
+        return NONE;
+    }
 
     for (polygon_index = 0, polygon = map_polygons; polygon_index < dynamic_world->polygon_count;
          ++polygon_index, ++polygon) {
@@ -2042,37 +2070,33 @@ short _find_line_crossed_leaving_polygon(short polygon_index,
 }
 
 static short _new_map_object(shape_descriptor shape, angle facing) {
-    struct object_data* object;
-    short object_index;
-
-    for (object_index = 0, object = objects; object_index < MAXIMUM_OBJECTS_PER_MAP; ++object_index, ++object) {
-        if (SLOT_IS_FREE(object)) {
-            /* initialize the object_data structure.  the defaults result in a normal (i.e., scenery),
-                non-solid object.  the rendered, animated and status flags are initially clear. */
-            object->polygon          = NONE;
-            object->shape            = shape;
-            object->facing           = facing;
-            object->transfer_mode    = NONE;
-            object->transfer_phase   = 0;
-            object->permutation      = 0;
-            object->sequence         = 0;
-            object->flags            = 0;
-            object->next_object      = NONE;
-            object->parasitic_object = NONE;
-            object->sound_pitch      = FIXED_ONE;
-
-            MARK_SLOT_AS_USED(object);
-
-            /* Objects with a shape of UNONE are invisible. */
-            if (shape == UNONE) {
-                SET_OBJECT_INVISIBILITY(object, true);
-            }
+    short object_index = ObjectSlots.find_free();
 
-            break;
+    if (object_index != NONE) {
+        struct object_data* object = objects + object_index;
+
+        /* initialize the object_data structure.  the defaults result in a normal (i.e., scenery),
+            non-solid object.  the rendered, animated and status flags are initially clear. */
+        object->polygon          = NONE;
+        object->shape            = shape;
+        object->facing           = facing;
+        object->transfer_mode    = NONE;
+        object->transfer_phase   = 0;
+        object->permutation      = 0;
+        object->sequence         = 0;
+        object->flags            = 0;
+        object->next_object      = NONE;
+        object->parasitic_object = NONE;
+        object->sound_pitch      = FIXED_ONE;
+
+        MARK_SLOT_AS_USED(object);
+        ObjectSlots.mark_used(object_index);
+
+        /* Objects with a shape of UNONE are invisible. */
+        if (shape == UNONE) {
+            SET_OBJECT_INVISIBILITY(object, true);
         }
     }
-    if (object_index == MAXIMUM_OBJECTS_PER_MAP)
-        object_index = NONE;
 
     return object_index;
 }
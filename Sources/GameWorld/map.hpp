@@ -1111,6 +1111,34 @@ std::pair<bool, int16> update_world(void);
 // ZZZ: these really don't go here, but they live in marathon2.cpp where update_world() lives.....
 void reset_intermediate_action_queues();
 void set_prediction_wanted(bool inPrediction);
+// predicted ticks also fire weapons and animate players, so a hub that never waits feels responsive
+void set_rollback_wanted(bool inRollback);
+// true while update_world() runs a tick it is going to roll back; nothing should be heard or scripted
+bool world_update_is_predictive();
+
+// Where the time in each world tick goes; only measured while profiling is on (for benchmarks)
+enum /* world update profile sections */
+{
+    _world_profile_lua_idle,
+    _world_profile_lights,
+    _world_profile_media,
+    _world_profile_platforms,
+    _world_profile_players,
+    _world_profile_projectiles,
+    _world_profile_monsters,
+    _world_profile_effects,
+    _world_profile_other,
+    NUMBER_OF_WORLD_PROFILE_SECTIONS
+};
+
+struct world_update_profile {
+    int64_t ticks;
+    double seconds[NUMBER_OF_WORLD_PROFILE_SECTIONS];
+};
+
+void set_world_update_profiling(bool enabled);
+void reset_world_update_profile();
+const world_update_profile& get_world_update_profile();
 
 /* Called to activate lights, platforms, etc. (original polygon may be NONE) */
 void changed_polygon(short original_polygon_index, short new_polygon_index, short player_index);
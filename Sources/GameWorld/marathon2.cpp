@@ -47,6 +47,7 @@
 // LP additions:
 #include "AnimatedTextures.hpp"
 #include "ChaseCam.hpp"
+#include "LevelPrefetch.hpp"
 #include "OGL_Setup.hpp"
 #include "tags.hpp"
 
@@ -69,11 +70,15 @@
 
 #include "motion_sensor.hpp"
 
+#include <chrono>
 #include <limits.h>
 #include <thread>
 
+#include "Tracing.hpp"
 #include "ephemera.hpp"
 #include "interpolated_world.hpp"
+#include "polygon_grid.hpp"
+#include "world_snapshot.hpp"
 
 /* ---------- constants */
 
@@ -138,37 +143,20 @@ static bool sPredictionWanted = false;
 
 void set_prediction_wanted(bool inPrediction) { sPredictionWanted = inPrediction; }
 
-static player_data sSavedPlayerData[MAXIMUM_NUMBER_OF_PLAYERS];
-static monster_data sSavedPlayerMonsterData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerParasiticObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static short sSavedPlayerObjectNextObject[MAXIMUM_NUMBER_OF_PLAYERS];
+// Rollback: when real flags arrive we go back to the last confirmed world (exit_predictive_mode)
+// and predict forward again, so predicted ticks may run anything the snapshot can undo.
+static bool sRollbackWanted = false;
 
-// For sanity-checking...
-static int32 sSavedTickCount;
-static uint16 sSavedRandomSeed;
+void set_rollback_wanted(bool inRollback) { sRollbackWanted = inRollback; }
 
-// ZZZ: If not already in predictive mode, save off partial game-state for later restoration.
-static void enter_predictive_mode() {
-    if (sPredictedTicks == 0) {
-        for (short i = 0; i < dynamic_world->player_count; i++) {
-            sSavedPlayerData[i] = *get_player_data(i);
-            if (sSavedPlayerData[i].monster_index != NONE) {
-                sSavedPlayerMonsterData[i] = *get_monster_data(sSavedPlayerData[i].monster_index);
-                if (sSavedPlayerMonsterData[i].object_index != NONE) {
-                    sSavedPlayerObjectData[i]       = *get_object_data(sSavedPlayerMonsterData[i].object_index);
-                    sSavedPlayerObjectNextObject[i] = sSavedPlayerObjectData[i].next_object;
-                    if (sSavedPlayerObjectData[i].parasitic_object != NONE)
-                        sSavedPlayerParasiticObjectData[i]
-                                = *get_object_data(sSavedPlayerObjectData[i].parasitic_object);
-                }
-            }
-        }
+static bool sInPredictiveTick = false;
 
-        // Sanity checking
-        sSavedTickCount  = dynamic_world->tick_count;
-        sSavedRandomSeed = get_random_seed();
-    }
+bool world_update_is_predictive() { return sInPredictiveTick; }
+
+// ZZZ: If not already in predictive mode, save off the game-state for later restoration.
+static void enter_predictive_mode() {
+    if (sPredictedTicks == 0)
+        take_world_snapshot();
 }
 
 
@@ -204,68 +192,30 @@ static void compare_memory(const char* inChunk1, const char* inChunk2, size_t in
 }
 #endif
 
-// ZZZ: if in predictive mode, restore the saved partial game-state (it'd better take us back
+// ZZZ: if in predictive mode, restore the saved game-state (it'd better take us back
 // to _exactly_ the same full game-state we saved earlier, else problems.)
 static void exit_predictive_mode() {
     if (sPredictedTicks > 0) {
+        // We *don't* restore this tiny part of the game-state back because
+        // otherwise the player can't use [] to scroll the inventory panel.
+        // [] scrolling happens outside the normal input/update system, so that's
+        // enough to persuade me that not restoring this won't OOS any more often
+        // than []-scrolling did before prediction.  :)
+        int16 saved_interface_flags[MAXIMUM_NUMBER_OF_PLAYERS];
+        int16 saved_interface_decay[MAXIMUM_NUMBER_OF_PLAYERS];
         for (short i = 0; i < dynamic_world->player_count; i++) {
-            player_data* player = get_player_data(i);
-
-            assert(player->monster_index == sSavedPlayerData[i].monster_index);
-
-            {
-                // We *don't* restore this tiny part of the game-state back because
-                // otherwise the player can't use [] to scroll the inventory panel.
-                // [] scrolling happens outside the normal input/update system, so that's
-                // enough to persuade me that not restoring this won't OOS any more often
-                // than []-scrolling did before prediction.  :)
-                int16 saved_interface_flags = player->interface_flags;
-                int16 saved_interface_decay = player->interface_decay;
-
-                *player = sSavedPlayerData[i];
-
-                player->interface_flags = saved_interface_flags;
-                player->interface_decay = saved_interface_decay;
-            }
-
-            if (sSavedPlayerData[i].monster_index != NONE) {
-                assert(get_monster_data(sSavedPlayerData[i].monster_index)->object_index
-                       == sSavedPlayerMonsterData[i].object_index);
-
-                *get_monster_data(sSavedPlayerData[i].monster_index) = sSavedPlayerMonsterData[i];
-
-                if (sSavedPlayerMonsterData[i].object_index != NONE) {
-                    assert(get_object_data(sSavedPlayerMonsterData[i].object_index)->parasitic_object
-                           == sSavedPlayerObjectData[i].parasitic_object);
-
-                    remove_object_from_polygon_object_list(sSavedPlayerMonsterData[i].object_index);
-
-                    *get_object_data(sSavedPlayerMonsterData[i].object_index) = sSavedPlayerObjectData[i];
+            saved_interface_flags[i] = get_player_data(i)->interface_flags;
+            saved_interface_decay[i] = get_player_data(i)->interface_decay;
+        }
 
-                    // We have to defer this insertion since the object lists could still have other players
-                    // in their predictive locations etc. - we need to reconstruct everything exactly as it
-                    // was when we entered predictive mode.
-                    deferred_add_object_to_polygon_object_list(sSavedPlayerMonsterData[i].object_index,
-                                                               sSavedPlayerObjectNextObject[i]);
+        restore_world_snapshot();
 
-                    if (sSavedPlayerObjectData[i].parasitic_object != NONE)
-                        *get_object_data(sSavedPlayerObjectData[i].parasitic_object)
-                                = sSavedPlayerParasiticObjectData[i];
-                }
-            }
+        for (short i = 0; i < dynamic_world->player_count; i++) {
+            get_player_data(i)->interface_flags = saved_interface_flags[i];
+            get_player_data(i)->interface_decay = saved_interface_decay[i];
         }
 
-        perform_deferred_polygon_object_list_manipulations();
-
         sPredictedTicks = 0;
-
-        // Sanity checking
-        if (sSavedTickCount != dynamic_world->tick_count)
-            logWarning("saved tick count %d != dynamic_world->tick_count %d", sSavedTickCount,
-                       dynamic_world->tick_count);
-
-        if (sSavedRandomSeed != get_random_seed())
-            logWarning("saved random seed %d != get_random_seed() %d", sSavedRandomSeed, get_random_seed());
     }
 }
 
@@ -309,61 +259,134 @@ enum {
 
 extern void update_world_view_camera();
 
+static bool world_update_profiling = false;
+static world_update_profile world_profile;
+
+void set_world_update_profiling(bool enabled) { world_update_profiling = enabled; }
+
+void reset_world_update_profile() { world_profile = world_update_profile(); }
+
+const world_update_profile& get_world_update_profile() { return world_profile; }
+
+#ifdef AB_TRACING
+static const char* world_profile_section_names[NUMBER_OF_WORLD_PROFILE_SECTIONS] = {
+        "L_Call_Idle",      "update_lights", "update_medias",  "update_platforms", "update_players",
+        "move_projectiles", "move_monsters", "update_effects", "update_world (other)"};
+static const bool world_update_tracing = true;
+#else
+static const bool world_update_tracing = false;
+#endif
+
+// Charges the time since the previous lap to a profile section (and the tracer, if built in)
+class WorldProfileTimer {
+  public:
+
+    WorldProfileTimer() {
+        if (world_update_profiling || world_update_tracing)
+            _last = std::chrono::steady_clock::now();
+    }
+
+    void lap(int section) {
+        if (!world_update_profiling && !world_update_tracing)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+#ifdef AB_TRACING
+        Tracer::instance()->record(world_profile_section_names[section], _last, now);
+#endif
+        if (world_update_profiling)
+            world_profile.seconds[section] += std::chrono::duration<double>(now - _last).count();
+        _last = now;
+    }
+
+  private:
+
+    std::chrono::steady_clock::time_point _last;
+};
+
 // ZZZ: split out from update_world()'s loop.
-static int update_world_elements_one_tick(bool& call_postidle) {
+// A predictive tick only touches what take_world_snapshot() covers: scripts, ambient
+// sounds, ephemera, texture animation and the like wait for the real tick.
+static int update_world_elements_one_tick(ModifiableActionQueues* queues, bool predictive, bool& call_postidle) {
+    TRACE_TICK(dynamic_world->tick_count, predictive);
+    WorldProfileTimer timer;
+
     if (m1_solo_player_in_terminal()) {
-        update_m1_solo_player_in_terminal(GameQueue);
+        update_m1_solo_player_in_terminal(queues);
         call_postidle = false;
     } else {
-        decode_hotkeys(*GameQueue);
-        L_Call_Idle();
+        decode_hotkeys(*queues);
+        timer.lap(_world_profile_other);
+        if (!predictive)
+            L_Call_Idle();
         call_postidle = true;
+        timer.lap(_world_profile_lua_idle);
 
         update_lights();
+        timer.lap(_world_profile_lights);
         update_medias();
+        timer.lap(_world_profile_media);
         update_platforms();
+        timer.lap(_world_profile_platforms);
 
-        update_control_panels(); // don't put after update_players
-        update_players(GameQueue, false);
+        if (!predictive)
+            update_control_panels(); // don't put after update_players
+        update_players(queues, predictive, sRollbackWanted);
+        timer.lap(_world_profile_players);
         move_projectiles();
+        timer.lap(_world_profile_projectiles);
         move_monsters();
+        timer.lap(_world_profile_monsters);
         update_effects();
-        recreate_objects();
+        timer.lap(_world_profile_effects);
+        // its countdown lives outside the snapshot
+        if (!predictive)
+            recreate_objects();
 
-        handle_random_sound_image();
+        if (!predictive)
+            handle_random_sound_image();
         animate_scenery();
 
-        update_ephemera();
+        if (!predictive)
+            update_ephemera();
 
         // LP additions:
         if (film_profile.animate_items) {
             animate_items();
         }
 
-        AnimTxtr_Update();
-        ChaseCam_Update();
-        motion_sensor_scan();
-        check_m1_exploration();
+        if (!predictive) {
+            AnimTxtr_Update();
+            ChaseCam_Update();
+            motion_sensor_scan();
+            check_m1_exploration();
 
 #if !defined(DISABLE_NETWORKING)
-        update_net_game();
+            update_net_game();
 #endif // !defined(DISABLE_NETWORKING)
+        }
     }
 
-    if (check_level_change()) {
-        sync_heartbeat_count();
-        return kUpdateChangeLevel;
-    }
+    if (!predictive) {
+        if (check_level_change()) {
+            sync_heartbeat_count();
+            return kUpdateChangeLevel;
+        }
 
 #if !defined(DISABLE_NETWORKING)
-    if (game_is_over()) {
-        return kUpdateGameOver;
-    }
+        if (game_is_over()) {
+            return kUpdateGameOver;
+        }
 #endif // !defined(DISABLE_NETWORKING)
+    }
 
     dynamic_world->tick_count                           += 1;
     dynamic_world->game_information.game_time_remaining -= 1;
 
+    timer.lap(_world_profile_other);
+    if (world_update_profiling && !predictive)
+        world_profile.ticks += 1;
+
     return kUpdateNormalCompletion;
 }
 
@@ -378,7 +401,10 @@ std::pair<bool, int16> update_world() {
 
 #ifndef DISABLE_NETWORKING
     if (game_is_networked) {
-        NetProcessMessagesInGame();
+        {
+            TRACE_SCOPE("NetProcessMessagesInGame");
+            NetProcessMessagesInGame();
+        }
 
         if (!NetCheckWorldUpdate()) {
             return std::pair<bool, int16_t>(false, 0);
@@ -421,7 +447,7 @@ std::pair<bool, int16> update_world() {
             sMostRecentFlagsForPlayer[i] = GameQueue->peekActionFlags(i, 0);
 
         bool call_postidle = true;
-        theUpdateResult    = update_world_elements_one_tick(call_postidle);
+        theUpdateResult    = update_world_elements_one_tick(GameQueue, false, call_postidle);
 
         theElapsedTime++;
 
@@ -461,7 +487,7 @@ std::pair<bool, int16> update_world() {
 
         // Observe, since we don't use a speed-limiter in predictive mode, that there cannot be flags
         // stranded in the GameQueue.  Unfortunately this approach will mispredict if a script is
-        // controlling the local player.  We could be smarter about it if that eventually becomes an issue.
+        // controlling the local player, since scripts don't run in predictive ticks.
         for (; sPredictedTicks < NetGetUnconfirmedActionFlagsCount(); sPredictedTicks++) {
             exit_interpolated_world();
 
@@ -476,8 +502,10 @@ std::pair<bool, int16> update_world() {
             }
 
             // update_players() will dequeue the elements we just put in there
-            decode_hotkeys(thePredictiveQueues);
-            update_players(&thePredictiveQueues, true);
+            bool call_postidle;
+            sInPredictiveTick = true;
+            update_world_elements_one_tick(&thePredictiveQueues, true, call_postidle);
+            sInPredictiveTick = false;
 
             didPredict = true;
 
@@ -555,6 +583,13 @@ bool entering_map(bool restoring_saved) {
     /* and since no monsters have paths, we should make sure no paths think they have monsters */
     reset_paths();
 
+    /* index the level’s polygons for world_point_to_polygon_index() */
+    build_polygon_grid();
+
+    /* start reading the replacement images this level used last time, while everything else loads */
+    if (get_screen_mode()->acceleration != _no_acceleration)
+        LevelPrefetch::instance()->begin(get_current_map_checksum(), dynamic_world->current_level_number);
+
     /* mark our shape collections for loading and load them */
     mark_environment_collections(static_world->environment_code, true);
     mark_all_monster_collections(true);
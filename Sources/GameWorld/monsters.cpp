@@ -30,6 +30,7 @@
 #include "Logging.hpp"
 #include "Packing.hpp"
 #include "SoundManager.hpp"
+#include "WorkerPool.hpp"
 #include "cseries.hpp"
 #include "effects.hpp"
 #include "fades.hpp"
@@ -57,6 +58,12 @@
 
 #define OBSTRUCTION_DEACTIVATION_MASK 0x7
 
+/* when a scenario asks for it (MML <monsters parallel_perception="true">, honored by film profiles with
+    monster_perception_opt_in), this many monsters get time each tick instead of one;
+    they all look around at the start of the tick, in parallel, and act on what they saw in index order
+    as move_monsters() reaches them, so nothing depends on how many threads did the looking */
+#define MAXIMUM_MONSTERS_PERCEIVING_PER_TICK 8
+
 #define EVASIVE_MANOUVER_DISTANCE WORLD_ONE_HALF
 
 #define MONSTER_EXTERNAL_DECELERATION     (WORLD_ONE / 200)
@@ -165,6 +172,9 @@ struct damage_kick_definition damage_kick_definitions[NUMBER_OF_DAMAGE_TYPES] =
 /* import monster definition constants, structures and globals */
 #include "monster_definitions.hpp"
 
+/* a monster slot freed and filled again since perceive_monsters() holds a different monster */
+static bool monsters_created_since_perception = false;
+
 /* ---------- private prototypes */
 
 static monster_definition* get_monster_definition(const short type);
@@ -340,6 +350,7 @@ short new_monster(struct object_location* location, short monster_type) {
                     monster->sound_location       = object->location;
                     monster->sound_location.z    += definition->height - (definition->height >> 1);
                     MARK_SLOT_AS_USED(monster);
+                    monsters_created_since_perception = true;
 
                     /* initialize the monster’s object */
                     if (definition->flags & _monster_is_invisible)
@@ -378,6 +389,120 @@ short new_monster(struct object_location* location, short monster_type) {
     return monster_index;
 }
 
+struct monster_perception {
+    short monster_index;
+    bool active;
+    short mode;
+    short looked_at; // the target a monster losing lock looked for
+    short target_index;
+};
+
+static std::vector<monster_perception> perceptions;
+static WorkerPool* perception_workers = NULL;
+
+// set by MML; classic pacing unless a scenario asks
+static bool parallel_perception_wanted = false;
+
+static bool monsters_perceive_in_parallel() {
+    return parallel_perception_wanted && film_profile.monster_perception_opt_in;
+}
+
+/* the monsters move_monsters() would give time to, were it their turn */
+static bool monster_wants_time(short monster_index) {
+    struct monster_data* monster = monsters + monster_index;
+
+    if (SLOT_IS_FREE(monster) || MONSTER_IS_PLAYER(monster))
+        return false;
+    if (!MONSTER_IS_ACTIVE(monster))
+        return !MONSTER_IS_BLIND(monster);
+
+    return !OBJECT_IS_INVISIBLE(get_object_data(monster->object_index)) && !MONSTER_IS_DYING(monster)
+        && (monster->mode == _monster_unlocked || monster->mode == _monster_lost_lock
+            || monster->mode == _monster_losing_lock);
+}
+
+/* only reads the world, so it can run on any thread */
+static short perceive_target(short monster_index, bool active, short mode, short looked_at) {
+    if (active && (mode == _monster_lost_lock || mode == _monster_losing_lock))
+        return clear_line_of_sight(monster_index, looked_at, false) ? looked_at : NONE;
+
+    return find_closest_appropriate_target(monster_index, false);
+}
+
+static void perceive_monsters(void) {
+    perceptions.clear();
+    monsters_created_since_perception = false;
+
+    /* starts after the last monster given time and wraps around, so a short batch at the end of the
+        list doesn't leave the next tick without any */
+    short first_index = dynamic_world->last_monster_index_to_get_time + 1;
+    for (short i = 0; i < MAXIMUM_MONSTERS_PER_MAP && perceptions.size() < MAXIMUM_MONSTERS_PERCEIVING_PER_TICK;
+         ++i) {
+        short monster_index = (first_index + i) % MAXIMUM_MONSTERS_PER_MAP;
+        if (monster_wants_time(monster_index)) {
+            struct monster_data* monster = monsters + monster_index;
+            monster_perception perception;
+
+            perception.monster_index = monster_index;
+            perception.active        = MONSTER_IS_ACTIVE(monster);
+            perception.mode          = monster->mode;
+            perception.looked_at     = monster->target_index;
+            perception.target_index  = NONE;
+            perceptions.push_back(perception);
+        }
+    }
+
+    if (!perception_workers)
+        perception_workers = new WorkerPool(WorkerPool::default_thread_count());
+
+    perception_workers->run(static_cast<int>(perceptions.size()), [](int i) {
+        monster_perception& perception = perceptions[i];
+        perception.target_index        = perceive_target(perception.monster_index, perception.active,
+                                                         perception.mode, perception.looked_at);
+    });
+
+    /* the next tick starts after the last of them */
+    dynamic_world->last_monster_index_to_get_time = perceptions.empty() ? -1 : perceptions.back().monster_index;
+}
+
+static const monster_perception* get_monster_perception(short monster_index) {
+    for (const auto& perception : perceptions) {
+        if (perception.monster_index == monster_index)
+            return &perception;
+    }
+
+    return NULL;
+}
+
+/* acts on what the monster saw, as the serial code would have; if it or its target has changed since
+    the start of the tick (including its target's slot going to a new monster), what it saw no longer
+    holds and it looks again now */
+static void apply_monster_perception(const monster_perception& perception) {
+    short monster_index          = perception.monster_index;
+    struct monster_data* monster = get_monster_data(monster_index);
+    bool active                  = MONSTER_IS_ACTIVE(monster);
+    short target_index           = perception.target_index;
+
+    bool still_holds = active == perception.active && (!active || monster->mode == perception.mode)
+                    && monster->target_index == perception.looked_at;
+    if (still_holds && target_index != NONE)
+        still_holds = SLOT_IS_USED(monsters + target_index) && !MONSTER_IS_DYING(monsters + target_index)
+                   && !monsters_created_since_perception;
+    if (!still_holds)
+        target_index = perceive_target(monster_index, active, monster->mode, monster->target_index);
+
+    if (!active) {
+        change_monster_target(monster_index, target_index);
+        if (MONSTER_HAS_VALID_TARGET(monster))
+            activate_nearby_monsters(monster->target_index, monster_index, _pass_one_zone_border,
+                                     MONSTER_ALERT_ACTIVATION_RANGE);
+    } else if (monster->mode == _monster_unlocked) {
+        change_monster_target(monster_index, target_index);
+    } else if (target_index != NONE) {
+        change_monster_target(monster_index, target_index);
+    }
+}
+
 /* assumes ∂t==1 tick */
 void move_monsters(void) {
     struct monster_data* monster;
@@ -385,6 +510,12 @@ void move_monsters(void) {
     bool monster_built_path = (dynamic_world->tick_count & 3) ? true : false;
     short monster_index;
 
+    /* platforms and media have moved since the last tick */
+    invalidate_shared_path_flood();
+
+    if (monsters_perceive_in_parallel())
+        perceive_monsters();
+
     for (monster_index = 0, monster = monsters; monster_index < MAXIMUM_MONSTERS_PER_MAP; ++monster_index, ++monster) {
         if (SLOT_IS_USED(monster) && !MONSTER_IS_PLAYER(monster)) {
             struct object_data* object = get_object_data(monster->object_index);
@@ -415,8 +546,15 @@ void move_monsters(void) {
                     animation_flags = GET_OBJECT_ANIMATION_FLAGS(object);
 
                     /* give this monster time, if we can and he needs it */
-                    if (!monster_got_time && monster_index > dynamic_world->last_monster_index_to_get_time
-                        && !MONSTER_IS_DYING(monster)) {
+                    if (monsters_perceive_in_parallel()) {
+                        const monster_perception* perception = get_monster_perception(monster_index);
+                        if (perception && !MONSTER_IS_DYING(monster)
+                            && (monster->mode == _monster_unlocked || monster->mode == _monster_lost_lock
+                                || monster->mode == _monster_losing_lock)) {
+                            apply_monster_perception(*perception);
+                        }
+                    } else if (!monster_got_time && monster_index > dynamic_world->last_monster_index_to_get_time
+                               && !MONSTER_IS_DYING(monster)) {
                         switch (monster->mode) {
                             case _monster_unlocked:
                                 /* if this monster is unlocked and we haven’t already given a monster time,
@@ -551,6 +689,10 @@ void move_monsters(void) {
                         }
                     }
                 }
+            } else if (monsters_perceive_in_parallel()) {
+                const monster_perception* perception = get_monster_perception(monster_index);
+                if (perception && !MONSTER_IS_BLIND(monster))
+                    apply_monster_perception(*perception);
             } else {
                 /* all inactive monsters get time to scan for targets */
                 if (!monster_got_time && !MONSTER_IS_BLIND(monster)
@@ -573,7 +715,7 @@ void move_monsters(void) {
 
     /* either there are no unlocked monsters or ‘dynamic_world->last_monster_index_to_get_time’ is higher than
         all of them (so we reset it to zero) ... same for paths */
-    if (!monster_got_time)
+    if (!monster_got_time && !monsters_perceive_in_parallel())
         dynamic_world->last_monster_index_to_get_time = -1;
     if (!monster_built_path)
         dynamic_world->last_monster_index_to_build_path = -1;
@@ -1000,6 +1142,37 @@ void deactivate_monster(short monster_index) {
     }
 }
 
+// The list being gathered by possible_intersecting_monsters is stamped: an object is in it if its stamp
+// is the list's, and a polygon's objects have already been walked for it if the polygon's stamp is.
+// This keeps both checks O(1), and the list comes out exactly as a walk of every polygon would make it.
+static vector<uint32> intersecting_object_stamps;
+static vector<uint32> intersecting_polygon_stamps;
+static vector<uint8> intersecting_polygon_found;
+static uint32 intersecting_stamp                      = 0;
+static const vector<short>* intersecting_stamped_list = NULL;
+
+static void stamp_intersecting_monsters_list(const vector<short>* IntersectedObjectsPtr) {
+    if (intersecting_object_stamps.size() < MAXIMUM_OBJECTS_PER_MAP)
+        intersecting_object_stamps.resize(MAXIMUM_OBJECTS_PER_MAP, 0);
+    if (intersecting_polygon_stamps.size() < MAXIMUM_POLYGONS_PER_MAP) {
+        intersecting_polygon_stamps.resize(MAXIMUM_POLYGONS_PER_MAP, 0);
+        intersecting_polygon_found.resize(MAXIMUM_POLYGONS_PER_MAP, false);
+    }
+
+    if (++intersecting_stamp == 0) {
+        std::fill(intersecting_object_stamps.begin(), intersecting_object_stamps.end(), 0);
+        std::fill(intersecting_polygon_stamps.begin(), intersecting_polygon_stamps.end(), 0);
+        intersecting_stamp = 1;
+    }
+
+    for (short object_index : *IntersectedObjectsPtr) intersecting_object_stamps[object_index] = intersecting_stamp;
+}
+
+void begin_intersecting_monsters_list(vector<short>* IntersectedObjectsPtr) {
+    stamp_intersecting_monsters_list(IntersectedObjectsPtr);
+    intersecting_stamped_list = IntersectedObjectsPtr;
+}
+
 /* returns a list of object indexes of all monsters in or adjacent to the given polygon,
     up to maximum_object_count. */
 // LP change: called with growable list
@@ -1013,9 +1186,25 @@ bool possible_intersecting_monsters(vector<short>* IntersectedObjectsPtr, unsign
     if (!neighbor_indexes)
         return found_solid_object;
 
+    // a list begun with begin_intersecting_monsters_list keeps its stamps from call to call
+    bool walked_polygons_known = IntersectedObjectsPtr && IntersectedObjectsPtr == intersecting_stamped_list;
+    if (IntersectedObjectsPtr && !walked_polygons_known) {
+        stamp_intersecting_monsters_list(IntersectedObjectsPtr);
+        intersecting_stamped_list = NULL;
+    }
+
     for (short i = 0; i < polygon->neighbor_count; ++i) {
-        struct polygon_data* neighboring_polygon = get_polygon_data(*neighbor_indexes++);
+        short neighbor_index                     = *neighbor_indexes++;
+        struct polygon_data* neighboring_polygon = get_polygon_data(neighbor_index);
+
+        // its solid objects are all in the list already, or it was full
+        if (walked_polygons_known && intersecting_polygon_stamps[neighbor_index] == intersecting_stamp) {
+            if (intersecting_polygon_found[neighbor_index])
+                found_solid_object = true;
+            continue;
+        }
 
+        bool found_in_polygon = false;
         if (!POLYGON_IS_DETACHED(neighboring_polygon)) {
             short object_index = neighboring_polygon->first_object;
 
@@ -1042,20 +1231,18 @@ bool possible_intersecting_monsters(vector<short>* IntersectedObjectsPtr, unsign
                     }
 
                     if (solid_object) {
-                        found_solid_object = true;
+                        found_in_polygon = true;
 
                         // LP change:
                         if (IntersectedObjectsPtr
                             && IntersectedObjectsPtr->size()
                                        < maximum_object_count) /* do we have enough space to add it? */
                         {
-                            unsigned j;
-
                             /* only add this object_index if it's not already in the list */
-                            vector<short>& IntersectedObjects = *IntersectedObjectsPtr;
-                            for (j = 0; j < IntersectedObjects.size() && IntersectedObjects[j] != object_index; ++j);
-                            if (j == IntersectedObjects.size())
-                                IntersectedObjects.push_back(object_index);
+                            if (intersecting_object_stamps[object_index] != intersecting_stamp) {
+                                intersecting_object_stamps[object_index] = intersecting_stamp;
+                                IntersectedObjectsPtr->push_back(object_index);
+                            }
                         }
                     }
                 }
@@ -1063,6 +1250,12 @@ bool possible_intersecting_monsters(vector<short>* IntersectedObjectsPtr, unsign
                 object_index = object->next_object;
             }
         }
+
+        if (walked_polygons_known) {
+            intersecting_polygon_stamps[neighbor_index] = intersecting_stamp;
+            intersecting_polygon_found[neighbor_index]  = found_in_polygon;
+        }
+        found_solid_object = found_solid_object || found_in_polygon;
     }
 
     return found_solid_object;
@@ -1935,8 +2128,10 @@ static void generate_new_path_for_monster(short monster_index) {
     data.monster               = monster;
     data.cross_zone_boundaries = destination_polygon_index == NONE ? false : true;
 
+    /* the cost function only depends on the monster’s definition and cross_zone_boundaries */
     monster->path = new_path((world_point2d*)&object->location, object->polygon, destination, destination_polygon_index,
-                             3 * definition->radius, monster_pathfinding_cost_function, &data);
+                             3 * definition->radius, monster_pathfinding_cost_function, &data,
+                             2 * monster->type + (data.cross_zone_boundaries ? 1 : 0));
     if (monster->path == NONE) {
         if (monster->action != _monster_is_being_hit || MONSTER_IS_DYING(monster))
             set_monster_action(monster_index, _monster_is_stationary);
@@ -3613,9 +3808,12 @@ void parse_mml_damage_kicks(const InfoTree& root) {
 void reset_mml_monsters() {
     monster_must_be_exterminated.clear();
     monster_must_be_exterminated.resize(NUMBER_OF_MONSTER_TYPES, false);
+    parallel_perception_wanted = false;
 }
 
 void parse_mml_monsters(const InfoTree& root) {
+    root.read_attr("parallel_perception", parallel_perception_wanted);
+
     for (const InfoTree& monster : root.children_named("monster")) {
         int16 index;
         if (!monster.read_indexed("index", index, NUMBER_OF_MONSTER_TYPES))
@@ -290,6 +290,9 @@ struct monster_definition* get_monster_definition_external(const short type);
 bool possible_intersecting_monsters(vector<short>* IntersectedObjectsPtr, unsigned maximum_object_count,
                                     short polygon_index, bool include_scenery);
 #define monsters_nearby(polygon_index) possible_intersecting_monsters(0, 0, (polygon_index), false)
+// starts a list for a run of possible_intersecting_monsters calls (a projectile crossing polygons), which then
+// skip neighbors already walked for it; the list and the world must not change between the calls
+void begin_intersecting_monsters_list(vector<short>* IntersectedObjectsPtr);
 
 void get_monster_dimensions(short monster_index, world_distance* radius, world_distance* height);
 
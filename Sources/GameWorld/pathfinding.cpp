@@ -69,6 +69,18 @@ struct path_definition /* 256 bytes */
 
 static struct path_definition* paths = NULL;
 
+/* the flood left behind by the last new_path() with a shared_flood_key; breadth-first floods expand
+    polygons in the same order no matter where they are headed, so another path from the same source
+    can pick up where it stopped.  anything that changes what the cost proc would say (objects
+    changing polygons, platforms switching, scripts) calls invalidate_shared_path_flood() */
+static struct {
+    bool valid;
+    uint32 flood;
+    cost_proc_ptr cost;
+    int32 key;
+    short source_polygon_index;
+} shared_flood;
+
 #ifdef VERIFY_PATH_SYNC
 static byte* path_validation_area = NULL;
 static int32 path_validation_area_index;
@@ -101,6 +113,7 @@ void reset_paths(void) {
     short path_index;
 
     for (path_index = 0; path_index < MAXIMUM_PATHS; ++path_index) paths[path_index].step_count = NONE;
+    invalidate_shared_path_flood();
 
 #ifdef VERIFY_PATH_SYNC
     path_run_count             += 1;
@@ -108,8 +121,16 @@ void reset_paths(void) {
 #endif
 }
 
+void invalidate_shared_path_flood(void) { shared_flood.valid = false; }
+
+void* get_path_storage(size_t* size) {
+    *size = MAXIMUM_PATHS * sizeof(struct path_definition);
+    return paths;
+}
+
 short new_path(world_point2d* source_point, short source_polygon_index, world_point2d* destination_point,
-               short destination_polygon_index, world_distance minimum_separation, cost_proc_ptr cost, void* data) {
+               short destination_polygon_index, world_distance minimum_separation, cost_proc_ptr cost, void* data,
+               int32 shared_flood_key) {
     short path_index;
 
     //	dprintf("#%d(#%d,#%d) #%d(#%d,#%d)", source_polygon_index, source_point->x, source_point->y,
@@ -146,12 +167,19 @@ short new_path(world_point2d* source_point, short source_polygon_index, world_po
         short polygon_index;
         short step_count;
         short depth;
+        bool resume_flood = shared_flood_key != NONE && shared_flood.valid && shared_flood.flood == current_flood_map()
+                            && shared_flood.cost == cost && shared_flood.key == shared_flood_key
+                            && shared_flood.source_polygon_index == source_polygon_index;
 
         if (destination_polygon_index != NONE) {
             /* NON-RANDOM PATH: we have a valid destination point: flood out from the source_polygon_index
                 until we reach destination_polygon_index or we run out of stack space */
 
-            polygon_index = flood_map(source_polygon_index, INT32_MAX, cost, _breadth_first, data);
+            if (resume_flood && rewind_flood_map(destination_polygon_index))
+                polygon_index = destination_polygon_index;
+            else
+                polygon_index = flood_map(resume_flood ? NONE : source_polygon_index, INT32_MAX, cost, _breadth_first,
+                                          data);
             while (polygon_index != NONE && polygon_index != destination_polygon_index) {
                 polygon_index = flood_map(NONE, INT32_MAX, cost, _breadth_first, data);
             }
@@ -165,13 +193,22 @@ short new_path(world_point2d* source_point, short source_polygon_index, world_po
                 of RANDOM_PATH_AREA, whichever comes first.  in fact, our destination_point, if
                 not NULL, is a 2d vector specifying a bias in the direction we want to travel
                 (usually this will be away from somewhere we don’t want to be) */
-            polygon_index = flood_map(source_polygon_index, INT32_MAX, cost, _breadth_first, data);
+            polygon_index
+                    = flood_map(resume_flood ? NONE : source_polygon_index, INT32_MAX, cost, _breadth_first, data);
             while (polygon_index != NONE) { polygon_index = flood_map(NONE, INT32_MAX, cost, _breadth_first, data); }
 
             choose_random_flood_node((world_vector2d*)destination_point); /* choose a random destination */
             reached_destination = false;                                  /* we didn’t even have one */
         }
 
+        if (shared_flood_key != NONE) {
+            shared_flood.valid                = true;
+            shared_flood.flood                = current_flood_map();
+            shared_flood.cost                 = cost;
+            shared_flood.key                  = shared_flood_key;
+            shared_flood.source_polygon_index = source_polygon_index;
+        }
+
         depth = flood_depth();
         if (reached_destination) {
             /* a depth of zero yeilds one point (the destination), two and greater 2*depth */
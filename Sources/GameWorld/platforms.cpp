@@ -27,6 +27,7 @@
 
 #include "InfoTree.hpp"
 #include "SoundManager.hpp"
+#include "flood_map.hpp"
 #include "lightsource.hpp"
 #include "map.hpp"
 #include "media.hpp"
@@ -574,6 +575,7 @@ bool set_platform_state(short platform_index, bool state, short parent_platform_
 
                 /* the state of this platform cannot be changed again this tick */
                 SET_PLATFORM_WAS_JUST_ACTIVATED_OR_DEACTIVATED(platform);
+                invalidate_shared_path_flood();
 
                 if (state) {
                     SET_PLATFORM_HAS_BEEN_ACTIVATED(platform);
@@ -463,7 +463,7 @@ void decode_hotkeys(ModifiableActionQueues& action_queues) {
 }
 
 /* assumes ∂t==1 tick */
-void update_players(ActionQueues* inActionQueuesToUse, bool inPredictive) {
+void update_players(ActionQueues* inActionQueuesToUse, bool inPredictive, bool inRollback) {
     struct player_data* player;
     short player_index;
 
@@ -619,6 +619,10 @@ void update_players(ActionQueues* inActionQueuesToUse, bool inPredictive) {
             update_player_media(player_index);
             set_player_shapes(player_index, true);
 
+        } else if (inRollback) {
+            // the parts of a tick a player notices first; all of it lives in the world snapshot
+            update_player_weapons(player_index, PLAYER_IS_DEAD(player) ? 0 : action_flags);
+            set_player_shapes(player_index, true);
         } // !inPredictive
 
     } // loop over players
@@ -724,8 +728,10 @@ void damage_player(short monster_index, short aggressor_index, short aggressor_t
                                         team_friendly_fire[aggressor_player->team].kills += 1;
                                     }
                                 }
-                                Console::instance()->report_kill(player_index, aggressor_player_index,
-                                                                 projectile_index);
+                                // a predicted kill would be reported again by the real tick
+                                if (!world_update_is_predictive())
+                                    Console::instance()->report_kill(player_index, aggressor_player_index,
+                                                                     projectile_index);
                             } else
 #endif // !defined(DISABLE_NETWORKING)
                             {
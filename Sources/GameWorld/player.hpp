@@ -479,7 +479,8 @@ void team_damage_from_player_data(void);
 // ZZZ: this now takes a set of ActionQueues as a parameter so the caller can redirect
 // the update routine's input.  Also, now callers can request a 'predictive update',
 // which changes less state, in an effort to make partial state saving/restoration successful.
-void update_players(ActionQueues* inActionQueuesToUse, bool inPredictive); /* assumes ∂t==1 tick */
+/* assumes ∂t==1 tick; with inRollback, predictive updates also run weapons and player shapes */
+void update_players(ActionQueues* inActionQueuesToUse, bool inPredictive, bool inRollback = false);
 void decode_hotkeys(ModifiableActionQueues& action_queues);
 
 // handle pausing Marathon 1 terminals
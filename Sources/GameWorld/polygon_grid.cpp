@@ -0,0 +1,202 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "polygon_grid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "map.hpp"
+
+namespace {
+
+// cells are about this big, unless that would make the grid too large
+constexpr int32_t kTargetCellSize      = 2 * WORLD_ONE;
+constexpr int32_t kMaximumCellsPerSide = 128;
+
+struct PolygonBounds {
+    int32_t x0, y0, x1, y1;
+};
+
+struct PolygonGrid {
+    bool built = false;
+
+    int32_t x0        = 0;
+    int32_t y0        = 0;
+    int32_t cell_size = 1;
+    int32_t columns   = 0;
+    int32_t rows      = 0;
+
+    // cell i holds cell_polygons[cell_starts[i]..cell_starts[i+1])
+    std::vector<uint32_t> cell_starts;
+    std::vector<int16_t> cell_polygons;
+
+    // polygons point_in_polygon() might accept points anywhere in; these are in every cell
+    std::vector<int16_t> unbounded_polygons;
+};
+
+PolygonGrid grid;
+
+} // namespace
+
+// point_in_polygon() tests the point against the line of every side; only when the sides form a
+// closed, convex, consistently wound loop is the region it accepts no bigger than the polygon.
+// Sides must also be short enough that its int32 cross products cannot overflow for any world point.
+static bool get_polygon_bounds(short polygon_index, PolygonBounds& bounds) {
+    polygon_data* polygon = get_polygon_data(polygon_index);
+    short vertex_count    = polygon->vertex_count;
+    short starts[MAXIMUM_VERTICES_PER_POLYGON], ends[MAXIMUM_VERTICES_PER_POLYGON];
+    bool has_area = false;
+
+    if (vertex_count < 3 || vertex_count > MAXIMUM_VERTICES_PER_POLYGON)
+        return false;
+
+    // orient every side the way point_in_polygon() does, so the inside is always on the same side
+    for (short i = 0; i < vertex_count; ++i) {
+        line_data* line = get_line_data(polygon->line_indexes[i]);
+        bool clockwise  = line->endpoint_indexes[0] == polygon->endpoint_indexes[i];
+
+        starts[i] = line->endpoint_indexes[clockwise ? 0 : 1];
+        ends[i]   = line->endpoint_indexes[clockwise ? 1 : 0];
+    }
+
+    for (short i = 0; i < vertex_count; ++i) {
+        world_point2d* e0 = &get_endpoint_data(starts[i])->vertex;
+        world_point2d* e1 = &get_endpoint_data(ends[i])->vertex;
+
+        if (ends[i] != starts[(i + 1) % vertex_count])
+            return false;
+        if (std::abs(e1->x - e0->x) + std::abs(e1->y - e0->y) > INT16_MAX)
+            return false;
+
+        for (short j = 0; j < vertex_count; ++j) {
+            world_point2d* p    = &get_endpoint_data(starts[j])->vertex;
+            int32 cross_product = (p->x - e0->x) * (e1->y - e0->y) - (p->y - e0->y) * (e1->x - e0->x);
+
+            if (cross_product > 0)
+                return false;
+            if (cross_product != 0)
+                has_area = true;
+        }
+
+        if (i == 0)
+            bounds = {e0->x, e0->y, e0->x, e0->y};
+        bounds.x0 = std::min<int32_t>(bounds.x0, e0->x);
+        bounds.y0 = std::min<int32_t>(bounds.y0, e0->y);
+        bounds.x1 = std::max<int32_t>(bounds.x1, e0->x);
+        bounds.y1 = std::max<int32_t>(bounds.y1, e0->y);
+    }
+
+    return has_area;
+}
+
+void clear_polygon_grid() {
+    grid.built = false;
+    grid.cell_starts.clear();
+    grid.cell_polygons.clear();
+    grid.unbounded_polygons.clear();
+}
+
+void build_polygon_grid() {
+    int16_t polygon_count = dynamic_world->polygon_count;
+    std::vector<PolygonBounds> bounds(polygon_count);
+    std::vector<bool> bounded(polygon_count);
+    PolygonBounds extent = {INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+
+    clear_polygon_grid();
+
+    for (int16_t i = 0; i < polygon_count; ++i) {
+        bounded[i] = get_polygon_bounds(i, bounds[i]);
+        if (bounded[i]) {
+            extent.x0 = std::min(extent.x0, bounds[i].x0);
+            extent.y0 = std::min(extent.y0, bounds[i].y0);
+            extent.x1 = std::max(extent.x1, bounds[i].x1);
+            extent.y1 = std::max(extent.y1, bounds[i].y1);
+        } else {
+            grid.unbounded_polygons.push_back(i);
+        }
+    }
+    if (extent.x0 > extent.x1)
+        extent = {0, 0, 0, 0};
+
+    int32_t longest_side = std::max(extent.x1 - extent.x0, extent.y1 - extent.y0) + 1;
+    grid.x0              = extent.x0;
+    grid.y0              = extent.y0;
+    grid.cell_size       = std::max(kTargetCellSize, (longest_side + kMaximumCellsPerSide - 1) / kMaximumCellsPerSide);
+    grid.columns         = (extent.x1 - extent.x0) / grid.cell_size + 1;
+    grid.rows            = (extent.y1 - extent.y0) / grid.cell_size + 1;
+
+    // count, then fill; walking the polygons in order keeps every cell sorted
+    int32_t cell_count = grid.columns * grid.rows;
+    grid.cell_starts.assign(cell_count + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<uint32_t> fill;
+        if (pass == 1) {
+            for (int32_t cell = 0; cell < cell_count; ++cell) grid.cell_starts[cell + 1] += grid.cell_starts[cell];
+            grid.cell_polygons.resize(grid.cell_starts[cell_count]);
+            fill.assign(grid.cell_starts.begin(), grid.cell_starts.end() - 1);
+        }
+
+        for (int16_t i = 0; i < polygon_count; ++i) {
+            int32_t column0 = 0, row0 = 0, column1 = grid.columns - 1, row1 = grid.rows - 1;
+            if (bounded[i]) {
+                column0 = (bounds[i].x0 - grid.x0) / grid.cell_size;
+                row0    = (bounds[i].y0 - grid.y0) / grid.cell_size;
+                column1 = (bounds[i].x1 - grid.x0) / grid.cell_size;
+                row1    = (bounds[i].y1 - grid.y0) / grid.cell_size;
+            }
+
+            for (int32_t row = row0; row <= row1; ++row) {
+                for (int32_t column = column0; column <= column1; ++column) {
+                    int32_t cell = row * grid.columns + column;
+                    if (pass == 0)
+                        grid.cell_starts[cell + 1] += 1;
+                    else
+                        grid.cell_polygons[fill[cell]++] = i;
+                }
+            }
+        }
+    }
+
+    grid.built = true;
+}
+
+bool get_polygon_grid_candidates(const world_point2d& p, const int16_t*& candidates, size_t& count) {
+    if (!grid.built)
+        return false;
+
+    int32_t dx = p.x - grid.x0;
+    int32_t dy = p.y - grid.y0;
+    if (dx < 0 || dy < 0 || dx / grid.cell_size >= grid.columns || dy / grid.cell_size >= grid.rows) {
+        candidates = grid.unbounded_polygons.data();
+        count      = grid.unbounded_polygons.size();
+    } else {
+        int32_t cell = (dy / grid.cell_size) * grid.columns + dx / grid.cell_size;
+        candidates   = grid.cell_polygons.data() + grid.cell_starts[cell];
+        count        = grid.cell_starts[cell + 1] - grid.cell_starts[cell];
+    }
+
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef POLYGON_GRID_H
+#define POLYGON_GRID_H
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+/*
+ *  Uniform grid over polygon bounding boxes, for finding the polygons near a point
+ *  without walking the whole map
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "world.hpp"
+
+// call once the level's geometry is loaded; endpoints never move afterwards
+void build_polygon_grid();
+void clear_polygon_grid();
+
+// Every polygon that could contain p, in ascending index order; returns false if
+// there is no grid (in which case every polygon is a candidate)
+bool get_polygon_grid_candidates(const world_point2d& p, const int16_t*& candidates, size_t& count);
+
+#endif
@@ -23,6 +23,7 @@
  */
 
 #include "projectiles.hpp"
+#include "SlotAllocator.hpp"
 #include "SoundManager.hpp"
 #include "cseries.hpp"
 #include "effects.hpp"
@@ -83,6 +84,8 @@ short human_projectile_override = NONE;
 // LP addition: growable list of intersected objects
 static vector<short> IntersectedObjects;
 
+static SlotAllocator<projectile_data> ProjectileSlots(ProjectileList);
+
 /* ---------- private prototypes */
 
 static short adjust_projectile_type(world_point3d* origin, short polygon_index, short type, short owner_index,
@@ -179,59 +182,55 @@ short new_projectile(world_point3d* origin, short polygon_index, world_point3d*
                                         damage_scale);
     definition = get_projectile_definition(type);
 
-    for (projectile_index = 0, projectile = projectiles; projectile_index < MAXIMUM_PROJECTILES_PER_MAP;
-         ++projectile_index, ++projectile) {
-        if (SLOT_IS_FREE(projectile)) {
-            angle facing, elevation;
-            short object_index;
-            struct object_data* object;
-
-            facing    = arctangent(_vector->x, _vector->y);
-            elevation = arctangent(isqrt(_vector->x * _vector->x + _vector->y * _vector->y), _vector->z);
-            if (delta_theta) {
-                if (!(definition->flags & _no_horizontal_error))
-                    facing = normalize_angle(facing + global_random() % (2 * delta_theta) - delta_theta);
-                if (!(definition->flags & _no_vertical_error))
-                    elevation
-                            = (definition->flags & _positive_vertical_error)
-                                      ? normalize_angle(elevation + global_random() % delta_theta)
-                                      : normalize_angle(elevation + global_random() % (2 * delta_theta) - delta_theta);
-            }
-
-            object_index = new_map_object3d(
-                    origin, polygon_index,
-                    definition->collection == NONE ? NONE : BUILD_DESCRIPTOR(definition->collection, definition->shape),
-                    facing);
-            if (object_index != NONE) {
-                object = get_object_data(object_index);
-
-                projectile->type                      = (definition->flags & _alien_projectile)
-                                                                ? (alien_projectile_override == NONE ? type : alien_projectile_override)
-                                                                : (human_projectile_override == NONE ? type : human_projectile_override);
-                projectile->object_index              = object_index;
-                projectile->owner_index               = owner_index;
-                projectile->target_index              = intended_target_index;
-                projectile->owner_type                = owner_type;
-                projectile->flags                     = 0;
-                projectile->gravity                   = 0;
-                projectile->ticks_since_last_contrail = projectile->contrail_count = 0;
-                projectile->elevation                                              = elevation;
-                projectile->distance_travelled                                     = 0;
-                projectile->damage_scale                                           = damage_scale;
-                MARK_SLOT_AS_USED(projectile);
-
-                SET_OBJECT_OWNER(object, _object_is_projectile);
-                object->sound_pitch = definition->sound_pitch;
-                L_Call_Projectile_Created(projectile_index);
-            } else {
-                projectile_index = NONE;
-            }
+    projectile_index = ProjectileSlots.find_free();
+    if (projectile_index != NONE) {
+        angle facing, elevation;
+        short object_index;
+        struct object_data* object;
+
+        projectile = projectiles + projectile_index;
+        facing     = arctangent(_vector->x, _vector->y);
+        elevation  = arctangent(isqrt(_vector->x * _vector->x + _vector->y * _vector->y), _vector->z);
+        if (delta_theta) {
+            if (!(definition->flags & _no_horizontal_error))
+                facing = normalize_angle(facing + global_random() % (2 * delta_theta) - delta_theta);
+            if (!(definition->flags & _no_vertical_error))
+                elevation
+                        = (definition->flags & _positive_vertical_error)
+                                  ? normalize_angle(elevation + global_random() % delta_theta)
+                                  : normalize_angle(elevation + global_random() % (2 * delta_theta) - delta_theta);
+        }
 
-            break;
+        object_index = new_map_object3d(
+                origin, polygon_index,
+                definition->collection == NONE ? NONE : BUILD_DESCRIPTOR(definition->collection, definition->shape),
+                facing);
+        if (object_index != NONE) {
+            object = get_object_data(object_index);
+
+            projectile->type                      = (definition->flags & _alien_projectile)
+                                                            ? (alien_projectile_override == NONE ? type : alien_projectile_override)
+                                                            : (human_projectile_override == NONE ? type : human_projectile_override);
+            projectile->object_index              = object_index;
+            projectile->owner_index               = owner_index;
+            projectile->target_index              = intended_target_index;
+            projectile->owner_type                = owner_type;
+            projectile->flags                     = 0;
+            projectile->gravity                   = 0;
+            projectile->ticks_since_last_contrail = projectile->contrail_count = 0;
+            projectile->elevation                                              = elevation;
+            projectile->distance_travelled                                     = 0;
+            projectile->damage_scale                                           = damage_scale;
+            MARK_SLOT_AS_USED(projectile);
+            ProjectileSlots.mark_used(projectile_index);
+
+            SET_OBJECT_OWNER(object, _object_is_projectile);
+            object->sound_pitch = definition->sound_pitch;
+            L_Call_Projectile_Created(projectile_index);
+        } else {
+            projectile_index = NONE;
         }
     }
-    if (projectile_index == MAXIMUM_PROJECTILES_PER_MAP)
-        projectile_index = NONE;
 
     return projectile_index;
 }
@@ -517,6 +516,7 @@ void remove_projectile(short projectile_index) {
     L_Invalidate_Projectile(projectile_index);
     remove_map_object(projectile->object_index);
     MARK_SLOT_AS_FREE(projectile);
+    ProjectileSlots.mark_free(projectile_index);
 }
 
 void remove_all_projectiles(void) {
@@ -682,6 +682,7 @@ uint16 translate_projectile(short type, world_point3d* old_location, short old_p
 
     contact = _hit_nothing;
     IntersectedObjects.clear();
+    begin_intersecting_monsters_list(&IntersectedObjects);
     old_polygon = get_polygon_data(old_polygon_index);
     if (new_polygon_index)
         *new_polygon_index = old_polygon_index;
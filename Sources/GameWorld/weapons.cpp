@@ -2157,8 +2157,10 @@ static bool handle_trigger_up(short player_index, short which_trigger) {
                 weapon->triggers[which_trigger].state    = _weapon_idle;
                 weapon->triggers[which_trigger].phase    = IDLE_PHASE_COUNT;
                 weapon->triggers[which_trigger].sequence = 0;
-                SoundManager::instance()->StopSound(player_index == current_player_index ? NONE : player->object_index,
-                                                    trigger_definition->charging_sound);
+                if (!world_update_is_predictive())
+                    SoundManager::instance()->StopSound(
+                            player_index == current_player_index ? NONE : player->object_index,
+                            trigger_definition->charging_sound);
             }
         }
     }
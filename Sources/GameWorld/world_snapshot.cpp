@@ -0,0 +1,148 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "world_snapshot.hpp"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include "SlotAllocator.hpp"
+#include "effects.hpp"
+#include "flood_map.hpp"
+#include "lightsource.hpp"
+#include "map.hpp"
+#include "media.hpp"
+#include "monsters.hpp"
+#include "platforms.hpp"
+#include "player.hpp"
+#include "projectiles.hpp"
+#include "weapons.hpp"
+
+extern player_weapon_data* get_player_weapon_data(const short player_index);
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+
+struct SnapshotRegion {
+    uint8* data;
+    size_t size;
+    std::vector<uint8> copy;
+};
+
+std::vector<SnapshotRegion> regions;
+uint16 saved_random_seed;
+
+template <typename T>
+void add_region(std::vector<SnapshotRegion>& list, T* data, size_t count) {
+    if (data && count)
+        list.push_back({reinterpret_cast<uint8*>(data), count * sizeof(T), {}});
+}
+
+template <typename T>
+void add_region(std::vector<SnapshotRegion>& list, std::vector<T>& array) {
+    add_region(list, array.data(), array.size());
+}
+
+// Everything a tick of world elements can write to; scripts, ephemera and the
+// rest of the presentation layer are kept out of predicted ticks instead
+std::vector<SnapshotRegion> world_regions() {
+    std::vector<SnapshotRegion> list;
+
+    add_region(list, dynamic_world, 1);
+
+    add_region(list, EndpointList);
+    add_region(list, LineList);
+    add_region(list, SideList);
+    add_region(list, PolygonList);
+    add_region(list, PlatformList);
+    add_region(list, LightList);
+    add_region(list, MediaList);
+    add_region(list, MapIndexList);
+
+    add_region(list, ObjectList);
+    add_region(list, MonsterList);
+    add_region(list, ProjectileList);
+    add_region(list, EffectList);
+
+    add_region(list, players, MAXIMUM_NUMBER_OF_PLAYERS);
+    add_region(list, get_player_weapon_data(0), MAXIMUM_NUMBER_OF_PLAYERS);
+    add_region(list, team_damage_given, NUMBER_OF_TEAM_COLORS);
+    add_region(list, team_damage_taken, NUMBER_OF_TEAM_COLORS);
+    add_region(list, team_monster_damage_taken, NUMBER_OF_TEAM_COLORS);
+    add_region(list, team_monster_damage_given, NUMBER_OF_TEAM_COLORS);
+    add_region(list, team_friendly_fire, NUMBER_OF_TEAM_COLORS);
+
+    size_t path_size;
+    add_region(list, static_cast<uint8*>(get_path_storage(&path_size)), path_size);
+
+    return list;
+}
+
+// Copy the pages of from that differ from to
+void copy_changed_pages(uint8* to, const uint8* from, size_t size) {
+    for (size_t offset = 0; offset < size; offset += kPageSize) {
+        size_t length = std::min(kPageSize, size - offset);
+        if (memcmp(to + offset, from + offset, length) != 0)
+            memcpy(to + offset, from + offset, length);
+    }
+}
+
+} // namespace
+
+void take_world_snapshot(void) {
+    std::vector<SnapshotRegion> current = world_regions();
+
+    // a new level (or a script adding sides) moves arrays around; start those copies over
+    if (current.size() != regions.size())
+        regions.clear();
+    regions.resize(current.size());
+
+    for (size_t i = 0; i < current.size(); ++i) {
+        SnapshotRegion& region = regions[i];
+        if (region.data != current[i].data || region.size != current[i].size) {
+            region.data = current[i].data;
+            region.size = current[i].size;
+            region.copy.assign(region.data, region.data + region.size);
+        } else {
+            copy_changed_pages(region.copy.data(), region.data, region.size);
+        }
+    }
+
+    saved_random_seed = get_random_seed();
+}
+
+void restore_world_snapshot(void) {
+    for (auto& region : regions) copy_changed_pages(region.data, region.copy.data(), region.size);
+
+    set_random_seed(saved_random_seed);
+
+    // a shared flood was costed against the world we just threw away
+    invalidate_shared_path_flood();
+
+    // and the free slots may be different ones again
+    invalidate_slot_allocators();
+}
@@ -0,0 +1,45 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  Snapshot of everything a world tick can change, so prediction can run whole ticks
+ *  and roll them back
+ *
+ *  The snapshot keeps its own copy of the world's arrays, split into pages. Taking a
+ *  snapshot only copies the pages that changed since the last one, and restoring it only
+ *  copies back the pages that were written to in between, so a few predicted ticks cost
+ *  about as much as the handful of monsters and projectiles they moved.
+ */
+
+// Remember the current state of the world
+void take_world_snapshot(void);
+
+// Put the world back the way it was at the last take_world_snapshot()
+void restore_world_snapshot(void);
+
+#endif
@@ -341,7 +341,7 @@ const luaL_Reg Lua_Ephemeras_Methods[] = {
         {0,         0                                 }
 };
 
-static bool Lua_Ephemera_Valid(int32 index) {
+static bool Lua_Ephemera_Valid(int16 index) {
     if (index < 0 || index >= get_dynamic_limit(_dynamic_limit_ephemera)) {
         return false;
     } else {
@@ -617,7 +617,7 @@ int Lua_Monster_Delete(lua_State* L) {
     return 0;
 }
 
-int Lua_Monster_Valid(int16 index) {
+bool Lua_Monster_Valid(int16 index) {
     if (index < 0 || index >= MAXIMUM_MONSTERS_PER_MAP)
         return false;
 
@@ -675,7 +675,7 @@ int Lua_Monster_Move_By_Path(lua_State* L) {
     destination = get_polygon_data(polygon_index)->center;
 
     monster->path = new_path((world_point2d*)&object->location, object->polygon, &destination, polygon_index,
-                             3 * definition->radius, monster_pathfinding_cost_function, &path);
+                             3 * definition->radius, monster_pathfinding_cost_function, &path, NONE);
     if (monster->path == NONE) {
         if (monster->action != _monster_is_being_hit || MONSTER_IS_DYING(monster)) {
             set_monster_action(monster_index, _monster_is_stationary);
@@ -282,7 +282,7 @@ const luaL_Reg Lua_Effect_Set[] = {
         {0,        0                    }
 };
 
-bool Lua_Effect_Valid(int32 index) {
+bool Lua_Effect_Valid(int16 index) {
     if (index < 0 || index >= MAXIMUM_EFFECTS_PER_MAP)
         return false;
 
@@ -420,7 +420,7 @@ const luaL_Reg Lua_Items_Methods[] = {
         {0,     0                             }
 };
 
-bool Lua_Item_Valid(int32 index) {
+bool Lua_Item_Valid(int16 index) {
     if (index < 0 || index >= MAXIMUM_OBJECTS_PER_MAP)
         return false;
 
@@ -431,7 +431,7 @@ bool Lua_Item_Valid(int32 index) {
 char Lua_ItemKind_Name[] = "item_kind";
 typedef L_Enum<Lua_ItemKind_Name> Lua_ItemKind;
 
-static bool Lua_ItemKind_Valid(int32 index) { return index >= 0 && index <= NUMBER_OF_ITEM_TYPES; }
+static bool Lua_ItemKind_Valid(int16 index) { return index >= 0 && index <= NUMBER_OF_ITEM_TYPES; }
 
 char Lua_ItemKinds_Name[] = "ItemKinds";
 typedef L_EnumContainer<Lua_ItemKinds_Name, Lua_ItemKind> Lua_ItemKinds;
@@ -556,7 +556,7 @@ static int Lua_ItemType_Set_Random_Location(lua_State* L) {
     return 0;
 }
 
-static bool Lua_ItemType_Valid(int32 index) { return index >= 0 && index < NUMBER_OF_DEFINED_ITEMS; }
+static bool Lua_ItemType_Valid(int16 index) { return index >= 0 && index < NUMBER_OF_DEFINED_ITEMS; }
 
 char Lua_ItemType_Name[]          = "item_type";
 const luaL_Reg Lua_ItemType_Get[] = {
@@ -588,7 +588,7 @@ char Lua_ItemTypes_Name[] = "ItemTypes";
 char Lua_SceneryType_Name[] = "scenery_type";
 typedef L_Enum<Lua_SceneryType_Name> Lua_SceneryType;
 
-static bool Lua_SceneryType_Valid(int32 index) { return index >= 0 && index <= NUMBER_OF_SCENERY_DEFINITIONS; }
+static bool Lua_SceneryType_Valid(int16 index) { return index >= 0 && index <= NUMBER_OF_SCENERY_DEFINITIONS; }
 
 char Lua_SceneryTypes_Name[] = "SceneryTypes";
 typedef L_EnumContainer<Lua_SceneryTypes_Name, Lua_SceneryType> Lua_SceneryTypes;
@@ -689,7 +689,7 @@ int Lua_Sceneries_New(lua_State* L) {
     return 1;
 }
 
-static bool Lua_Scenery_Valid(int32 index) {
+static bool Lua_Scenery_Valid(int16 index) {
     if (index < 0 || index >= MAXIMUM_OBJECTS_PER_MAP)
         return false;
 
@@ -258,7 +258,7 @@ const luaL_Reg Lua_Camera_Get[] = {
         {0,             0                                     }
 };
 
-static int Lua_Camera_Valid(int16 index) { return index >= 0 && index < lua_cameras.size(); }
+static bool Lua_Camera_Valid(int16 index) { return index >= 0 && index < lua_cameras.size(); }
 
 char Lua_Cameras_Name[] = "Cameras";
 typedef L_Container<Lua_Cameras_Name, Lua_Camera> Lua_Cameras;
@@ -0,0 +1,198 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "lua_profiler.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+
+LuaProfiler* LuaProfiler::instance() {
+    static LuaProfiler* instance_ = nullptr;
+    if (!instance_)
+        instance_ = new LuaProfiler();
+    return instance_;
+}
+
+LuaProfiler::LuaProfiler()
+    : _running(false), _budget_ms(1.0), _default_allocator(nullptr), _default_ud(nullptr), _sample_count(0),
+      _allocations(0), _allocated_bytes(0) {
+    _active.reserve(16);
+}
+
+void LuaProfiler::attach(lua_State* L) {
+    lua_Alloc allocator = lua_getallocf(L, &_default_ud);
+    if (!_default_allocator)
+        _default_allocator = allocator;
+    lua_setallocf(L, allocate, this);
+
+    _states.insert(L);
+    if (_running)
+        lua_sethook(L, sample, LUA_MASKCOUNT, kSampleInstructions);
+}
+
+void LuaProfiler::detach(lua_State* L) { _states.erase(L); }
+
+void LuaProfiler::start() {
+    if (_running)
+        return;
+
+    _running = true;
+    for (auto L : _states) lua_sethook(L, sample, LUA_MASKCOUNT, kSampleInstructions);
+}
+
+void LuaProfiler::stop() {
+    if (!_running)
+        return;
+
+    _running = false;
+    for (auto L : _states) lua_sethook(L, nullptr, 0, 0);
+}
+
+void LuaProfiler::reset() {
+    // calls in progress go unrecorded
+    for (auto& active : _active) active.stats = nullptr;
+
+    _triggers.clear();
+    _samples.clear();
+    _sample_count    = 0;
+    _allocations     = 0;
+    _allocated_bytes = 0;
+}
+
+void LuaProfiler::begin_trigger(const char* name) {
+    if (!_running) {
+        _active.push_back({nullptr, clock::time_point()});
+        return;
+    }
+
+    auto it = _triggers.find(name);
+    if (it == _triggers.end())
+        it = _triggers.emplace(name, TriggerStats()).first;
+    _active.push_back({&it->second, clock::now()});
+}
+
+void LuaProfiler::end_trigger() {
+    if (_active.empty())
+        return;
+
+    ActiveTrigger active = _active.back();
+    _active.pop_back();
+    if (!active.stats || !_running)
+        return;
+
+    double milliseconds = std::chrono::duration<double, std::milli>(clock::now() - active.start).count();
+
+    TriggerStats& stats  = *active.stats;
+    stats.calls         += 1;
+    stats.total_ms      += milliseconds;
+    stats.max_ms         = std::max(stats.max_ms, milliseconds);
+    if (milliseconds > _budget_ms)
+        stats.over_budget += 1;
+}
+
+void* LuaProfiler::allocate(void* ud, void* ptr, size_t osize, size_t nsize) {
+    LuaProfiler* profiler = static_cast<LuaProfiler*>(ud);
+
+    // for a new block, Lua passes the kind of object in osize
+    if (profiler->_running && nsize > (ptr ? osize : 0)) {
+        profiler->_allocations     += 1;
+        profiler->_allocated_bytes += nsize;
+
+        if (!profiler->_active.empty() && profiler->_active.back().stats) {
+            TriggerStats& stats    = *profiler->_active.back().stats;
+            stats.allocations     += 1;
+            stats.allocated_bytes += nsize;
+        }
+    }
+
+    return profiler->_default_allocator(profiler->_default_ud, ptr, osize, nsize);
+}
+
+void LuaProfiler::sample(lua_State* L, lua_Debug* ar) {
+    if (!lua_getinfo(L, "Sln", ar))
+        return;
+
+    char key[256];
+    snprintf(key, sizeof(key), "%s:%d (%s)", ar->short_src, ar->linedefined, ar->name ? ar->name : "?");
+
+    LuaProfiler* profiler = instance();
+    profiler->_samples[key] += 1;
+    profiler->_sample_count += 1;
+}
+
+std::vector<std::string> LuaProfiler::report(size_t max_rows) const {
+    std::vector<std::string> lines;
+    char line[512];
+
+    std::vector<std::pair<const char*, const TriggerStats*>> triggers;
+    for (const auto& it : _triggers) triggers.push_back({it.first, &it.second});
+    std::sort(triggers.begin(), triggers.end(),
+              [](const auto& a, const auto& b) { return a.second->total_ms > b.second->total_ms; });
+
+    snprintf(line, sizeof(line), "%-32s %8s %10s %8s %8s %6s %10s", "trigger", "calls", "total ms", "avg ms",
+             "max ms", "over", "allocs");
+    lines.push_back(line);
+    for (size_t i = 0; i < triggers.size() && i < max_rows; ++i) {
+        const TriggerStats& stats = *triggers[i].second;
+        snprintf(line, sizeof(line), "%-32s %8llu %10.3f %8.3f %8.3f %6llu %10llu", triggers[i].first,
+                 static_cast<unsigned long long>(stats.calls), stats.total_ms,
+                 stats.calls ? stats.total_ms / stats.calls : 0.0, stats.max_ms,
+                 static_cast<unsigned long long>(stats.over_budget),
+                 static_cast<unsigned long long>(stats.allocations));
+        lines.push_back(line);
+    }
+    snprintf(line, sizeof(line), "over budget: slower than %.3f ms; %llu allocations (%llu KB) in all",
+             _budget_ms, static_cast<unsigned long long>(_allocations),
+             static_cast<unsigned long long>(_allocated_bytes / 1024));
+    lines.push_back(line);
+
+    std::vector<std::pair<const std::string*, uint64_t>> samples;
+    for (const auto& it : _samples) samples.push_back({&it.first, it.second});
+    std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    snprintf(line, sizeof(line), "%-64s %8s %6s", "function", "samples", "%");
+    lines.push_back(line);
+    for (size_t i = 0; i < samples.size() && i < max_rows; ++i) {
+        snprintf(line, sizeof(line), "%-64s %8llu %5.1f%%", samples[i].first->c_str(),
+                 static_cast<unsigned long long>(samples[i].second), 100.0 * samples[i].second / _sample_count);
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+bool LuaProfiler::write_report(const std::string& path) const {
+#ifdef __WIN32__
+    FILE* file = _wfopen(utf8_to_wide(path).c_str(), L"w");
+#else
+    FILE* file = fopen(path.c_str(), "w");
+#endif
+    if (!file)
+        return false;
+
+    for (const auto& line : report(SIZE_MAX)) fprintf(file, "%s\n", line.c_str());
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,131 @@
+#ifndef __LUA_PROFILER_H
+#define __LUA_PROFILER_H
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  Profiler for the embedded Lua states
+ *
+ *  While running, it times every trigger call (flagging calls over a per-call budget),
+ *  counts the allocations each trigger makes, and samples the running Lua function every
+ *  few thousand VM instructions through a count hook. Stopped, it costs one flag test
+ *  per trigger and per allocation. Driven from the console ("luaprofile start", "show",
+ *  "save", ...); see Console::register_lua_profile_commands.
+ */
+
+#include "cseries.hpp"
+
+extern "C" {
+#include "lua.h"
+}
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class LuaProfiler {
+  public:
+
+    typedef std::chrono::steady_clock clock;
+
+    static LuaProfiler* instance();
+
+    // Every Lua state is attached while it exists, so starting the profiler reaches all of them
+    void attach(lua_State* L);
+    void detach(lua_State* L);
+
+    bool running() const { return _running; }
+
+    void start();
+    void stop();
+    void reset();
+
+    // Calls slower than this count as over budget
+    double budget() const { return _budget_ms; }
+
+    void set_budget(double milliseconds) { _budget_ms = milliseconds; }
+
+    // Triggers can nest (a script killing a monster runs monster_killed inside idle), so
+    // trigger times include nested triggers; name must outlive the profiler (a string literal)
+    void begin_trigger(const char* name);
+    void end_trigger();
+
+    // Slowest triggers and hottest functions first, at most max_rows of each
+    std::vector<std::string> report(size_t max_rows) const;
+    bool write_report(const std::string& path) const;
+
+  private:
+
+    LuaProfiler();
+
+    struct TriggerStats {
+        uint64_t calls;
+        uint64_t over_budget;
+        double total_ms;
+        double max_ms;
+        uint64_t allocations;
+        uint64_t allocated_bytes;
+    };
+
+    struct ActiveTrigger {
+        TriggerStats* stats;
+        clock::time_point start;
+    };
+
+    static const int kSampleInstructions = 1000;
+
+    static void* allocate(void* ud, void* ptr, size_t osize, size_t nsize);
+    static void sample(lua_State* L, lua_Debug* ar);
+
+    bool _running;
+    double _budget_ms;
+
+    std::set<lua_State*> _states;
+    lua_Alloc _default_allocator; // what luaL_newstate gave the first state
+    void* _default_ud;
+
+    std::unordered_map<const char*, TriggerStats> _triggers;
+    std::vector<ActiveTrigger> _active;
+
+    std::unordered_map<std::string, uint64_t> _samples; // by "source:line (name)"
+    uint64_t _sample_count;
+
+    uint64_t _allocations; // including those outside triggers
+    uint64_t _allocated_bytes;
+};
+
+// Accounts a trigger call to the profiler for as long as it is in scope
+class LuaTriggerScope {
+  public:
+
+    explicit LuaTriggerScope(const char* name) { LuaProfiler::instance()->begin_trigger(name); }
+
+    ~LuaTriggerScope() { LuaProfiler::instance()->end_trigger(); }
+};
+
+#endif
@@ -312,7 +312,7 @@ const luaL_Reg Lua_Projectiles_Methods[] = {
         {0,     0                                              }
 };
 
-bool Lua_Projectile_Valid(int32 index) {
+bool Lua_Projectile_Valid(int16 index) {
     if (index < 0 || index >= MAXIMUM_PROJECTILES_PER_MAP)
         return false;
 
@@ -350,7 +350,7 @@ const luaL_Reg Lua_ProjectileType_Get[] = {
 
 char Lua_ProjectileTypes_Name[] = "ProjectileTypes";
 
-static bool Lua_ProjectileType_Valid(int32 index) { return (index >= 0 && index < NUMBER_OF_PROJECTILE_TYPES); }
+static bool Lua_ProjectileType_Valid(int16 index) { return (index >= 0 && index < NUMBER_OF_PROJECTILE_TYPES); }
 
 static void compatibility(lua_State* L);
 
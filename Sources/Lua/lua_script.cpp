@@ -80,6 +80,7 @@ extern "C" {
 #include "lua_music.hpp"
 #include "lua_objects.hpp"
 #include "lua_player.hpp"
+#include "lua_profiler.hpp"
 #include "lua_projectiles.hpp"
 #include "lua_saved_objects.hpp"
 #include "lua_script.hpp"
@@ -149,9 +150,12 @@ class LuaState {
 
   public:
 
-    LuaState() : running_(false), num_scripts_(0) { state_.reset(luaL_newstate(), lua_close); }
+    LuaState() : running_(false), num_scripts_(0), trigger_(nullptr) {
+        state_.reset(luaL_newstate(), lua_close);
+        LuaProfiler::instance()->attach(State());
+    }
 
-    virtual ~LuaState() {}
+    virtual ~LuaState() { LuaProfiler::instance()->detach(State()); }
 
   public:
 
@@ -263,6 +267,7 @@ class LuaState {
 
     bool running_;
     int num_scripts_;
+    const char* trigger_; // what GetTrigger last found, for the profiler
 };
 
 typedef LuaState EmbeddedLuaState;
@@ -299,10 +304,12 @@ bool LuaState::GetTrigger(const char* trigger) {
     }
 
     lua_remove(State(), -2);
+    trigger_ = trigger;
     return true;
 }
 
 void LuaState::CallTrigger(int numArgs) {
+    LuaTriggerScope scope(trigger_);
     if (lua_pcall(State(), numArgs, 0, 0) == LUA_ERRRUN)
         L_Error(lua_tostring(State(), -1));
 }
@@ -570,6 +577,7 @@ void LuaState::ItemCreated(short item_index) {
 
 bool LuaState::CalculateCompletionState(short& completion_state) {
     if (GetTrigger("calculate_level_completion_state")) {
+        LuaTriggerScope scope(trigger_);
         if (lua_pcall(State(), 0, 1, 0) == LUA_ERRRUN) {
             L_Error(lua_tostring(State(), -1));
         }
@@ -919,7 +927,6 @@ int LuaState::RestoreAll(const std::string& s) {
         lua_settable(State(), LUA_REGISTRYINDEX); // muahaha
         lua_pushboolean(State(), true);
     } else {
-        lua_pop(State(), 2);
         lua_pushboolean(State(), false);
     }
 
@@ -1078,7 +1085,14 @@ static bool LuaRunning() {
 // call f on each Lua state
 template <class UnaryFunction>
 void L_Dispatch(const UnaryFunction& f) {
+    // predicted ticks get thrown away, and there's no taking back what a script did
+    if (world_update_is_predictive())
+        return;
+
     for (state_map::iterator it = states.begin(); it != states.end(); ++it) { f(it->second); }
+
+    // scripts can change anything monsters path through
+    invalidate_shared_path_flood();
 }
 
 void L_Call_Init(bool fRestoringSaved) {
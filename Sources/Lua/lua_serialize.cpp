@@ -1,151 +1,327 @@
-/*
- *
- *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
- *  and the Aleph Bet developers.
- *
- *  Aleph Bet is free software: you can redistribute it and/or modify it
- *  under the terms of the GNU General Public License as published by the
- *  Free Software Foundation, either version 3 of the License, or (at your
- *  option) any later version.
- *
- *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
- *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
- *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
- *  more details.
- *
- *  You should have received a copy of the GNU General Public License along
- *  with this program. If not, see <https://www.gnu.org/licenses/>.
- *
- *  This license notice applies only to the Aleph Bet engine itself, and
- *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
- *  and assets, nor to elements of any third-party scenarios.
- *
- */
-
 #include "lua_serialize.hpp"
 #include "Logging.hpp"
 
 #include "BStream.hpp"
 
+#include <string.h>
+
+/*
+ *  Version 2 snapshots are flat: the strings, then the saved value, then one record per
+ *  table (its id and its key/value pairs). Tables and strings are written as ids, so each
+ *  string is written once however many tables use it. Version 1 data was one recursive
+ *  walk of the value, and can still be restored.
+ */
+
 const static int SAVED_REFERENCE_PSEUDOTYPE = -2;
-const uint16 kVersion                       = 1;
+const uint16 kVersion                       = 2;
 
 static bool valid_key(int type) {
     return (type == LUA_TNUMBER || type == LUA_TBOOLEAN || type == LUA_TSTRING || type == LUA_TTABLE
             || type == LUA_TUSERDATA);
 }
 
-static void save(lua_State* L, BOStreamBE& s, uint32& counter) {
-    // if the object has already been written, write a reference to it
+int lua_arena_buffer::overflow(int ch) {
+    if (ch == traits_type::eof())
+        return traits_type::not_eof(ch);
 
-    lua_pushvalue(L, -1);
-    lua_rawget(L, 1);
-    if (!lua_isnil(L, -1)) {
-        s << static_cast<int8>(SAVED_REFERENCE_PSEUDOTYPE) << static_cast<uint32>(lua_tonumber(L, -1));
-        lua_pop(L, 1);
-        return;
+    // grow, keeping what's been written
+    size_t used = size();
+    m_storage.resize(std::max<size_t>(4096, 2 * m_storage.size()));
+    setp(m_storage.data(), m_storage.data() + m_storage.size());
+    pbump(static_cast<int>(used));
+
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+}
+
+static uint64_t hash_bytes(const char* data, size_t size) {
+    // FNV-1a a word at a time, folding the high bits back down after each
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash        = 14695981039346656037ULL;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash  = (hash ^ word) * prime;
+        hash ^= hash >> 32;
     }
+    for (; i < size; ++i) hash = (hash ^ static_cast<uint8>(data[i])) * prime;
+
+    return hash;
+}
+
+// values of other types, and userdata that isn't ours, are left out
+static bool saveable(lua_State* L, int index) {
+    int type = lua_type(L, index);
+    if (type != LUA_TUSERDATA)
+        return valid_key(type);
+
+    if (!lua_getmetatable(L, index))
+        return false;
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    bool ours = lua_type(L, -1) == LUA_TSTRING;
     lua_pop(L, 1);
+    return ours;
+}
 
-    s << static_cast<int8>(lua_type(L, -1));
-    switch (lua_type(L, -1)) {
-        case LUA_TNIL:
-            break;
-        case LUA_TNUMBER: {
-            s << static_cast<double>(lua_tonumber(L, -1));
-        } break;
-        case LUA_TBOOLEAN:
-            s << static_cast<uint8>(lua_toboolean(L, -1) ? 1 : 0);
-            break;
-        case LUA_TSTRING: {
-            s << static_cast<uint32>(lua_rawlen(L, -1));
-            s.write(lua_tostring(L, -1), lua_rawlen(L, -1));
-        } break;
-        case LUA_TTABLE: {
-            // add to the reference table
-            lua_pushvalue(L, -1);
-            lua_pushnumber(L, static_cast<lua_Number>(++counter));
-            lua_rawset(L, 1);
+struct LuaSnapshotWriter::Context {
+    lua_State* L;
+    int ids;     // table or string -> id, kept between snapshots
+    int pending; // 1..n -> the tables this snapshot has reached, in the same order as m_pending
+    LuaSnapshotWriter& writer;
+    BOStreamBE& strings;
+    BOStreamBE& records;
+};
+
+uint32 LuaSnapshotWriter::string_id(Context& c, int index) {
+    index = lua_absindex(c.L, index);
+
+    lua_pushvalue(c.L, index);
+    lua_rawget(c.L, c.ids);
+    uint32 id = static_cast<uint32>(lua_tonumber(c.L, -1));
+    lua_pop(c.L, 1);
+
+    if (!id) {
+        id = ++c.writer.m_next_string;
+        lua_pushvalue(c.L, index);
+        lua_pushnumber(c.L, static_cast<lua_Number>(id));
+        lua_rawset(c.L, c.ids);
+
+        size_t length;
+        const char* string = lua_tolstring(c.L, index, &length);
+        c.strings << static_cast<uint32>(length);
+        c.strings.write(string, length);
+    }
 
-            // write the reference
-            s << counter;
+    return id;
+}
 
-            // write all k/v pairs
-            lua_pushnil(L);
-            while (lua_next(L, -2)) {
-                if (valid_key(lua_type(L, -2))) {
-                    // another key
-                    lua_pushvalue(L, -2);
+uint32 LuaSnapshotWriter::table_id(Context& c, int index) {
+    index = lua_absindex(c.L, index);
 
-                    save(L, s, counter);
-                    lua_pop(L, 1);
+    lua_pushvalue(c.L, index);
+    lua_rawget(c.L, c.ids);
+    uint32 id = static_cast<uint32>(lua_tonumber(c.L, -1));
+    lua_pop(c.L, 1);
 
-                    save(L, s, counter);
-                    lua_pop(L, 1);
-                } else {
-                    lua_pop(L, 1);
-                }
-            }
+    LuaSnapshotWriter& w = c.writer;
+    if (!id) {
+        id = ++w.m_next_table;
+        lua_pushvalue(c.L, index);
+        lua_pushnumber(c.L, static_cast<lua_Number>(id));
+        lua_rawset(c.L, c.ids);
 
-            lua_pushnil(L);
-            save(L, s, counter);
-            lua_pop(L, 1);
-        } break;
-        case LUA_TUSERDATA: {
-            // add to the reference table
-            lua_pushvalue(L, -1);
-            lua_pushnumber(L, static_cast<lua_Number>(++counter));
-            lua_rawset(L, 1);
+        w.m_tables.push_back({0, 0});
+    }
 
-            // write the reference
-            s << counter;
+    // its record gets written once per snapshot
+    if (w.m_tables[id - 1].snapshot != w.m_snapshot) {
+        w.m_tables[id - 1].snapshot = w.m_snapshot;
+        w.m_pending.push_back(id);
 
-            // assume that this is one of our userdata
-            lua_getmetatable(L, -1);
-            lua_gettable(L, LUA_REGISTRYINDEX);
+        lua_pushvalue(c.L, index);
+        lua_rawseti(c.L, c.pending, static_cast<int>(w.m_pending.size()));
+    }
 
-            s << static_cast<uint8>(lua_rawlen(L, -1));
-            s.write(lua_tostring(L, -1), lua_rawlen(L, -1));
-            lua_pop(L, 1);
+    return id;
+}
 
-            lua_getfield(L, -1, "index");
+void LuaSnapshotWriter::save_value(Context& c, int index) {
+    index = lua_absindex(c.L, index);
 
-            s << static_cast<uint32>(lua_tonumber(L, -1));
-            lua_pop(L, 1);
+    int type = saveable(c.L, index) ? lua_type(c.L, index) : LUA_TNIL;
+    switch (type) {
+        case LUA_TNUMBER:
+            c.records << static_cast<int8>(type) << static_cast<double>(lua_tonumber(c.L, index));
+            break;
+        case LUA_TBOOLEAN:
+            c.records << static_cast<int8>(type) << static_cast<uint8>(lua_toboolean(c.L, index) ? 1 : 0);
+            break;
+        case LUA_TSTRING: {
+            uint32 id = string_id(c, index);
+            c.records << static_cast<int8>(type) << id;
+        } break;
+        case LUA_TTABLE: {
+            uint32 id = table_id(c, index);
+            c.records << static_cast<int8>(type) << id;
         } break;
+        case LUA_TUSERDATA: {
+            // one of ours, so its metatable maps to its class name in the registry
+            lua_getmetatable(c.L, index);
+            lua_rawget(c.L, LUA_REGISTRYINDEX);
+            uint32 name = string_id(c, -1);
+            lua_pop(c.L, 1);
+
+            lua_getfield(c.L, index, "index");
+            uint32 object_index = static_cast<uint32>(lua_tonumber(c.L, -1));
+            lua_pop(c.L, 1);
 
+            c.records << static_cast<int8>(type) << name << object_index;
+        } break;
         default:
-            // we silently ignore other types
+            c.records << static_cast<int8>(LUA_TNIL);
             break;
     }
 }
 
-bool lua_save(lua_State* L, std::streambuf* sb) {
-    lua_assert(lua_gettop(L) == 1);
+bool LuaSnapshotWriter::save(lua_State* L, std::streambuf* sb, bool delta) {
+    // after a reset there's nothing to be a delta from
+    if (!m_next_table && !m_next_string)
+        delta = false;
+    if (!delta)
+        reset(L);
+
+    int value = lua_gettop(L);
 
-    // create a references table
+    push_ids_key(L);
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+
+        // tables that are collected don't need their ids any more
+        lua_newtable(L);
+        lua_newtable(L);
+        lua_pushstring(L, "k");
+        lua_setfield(L, -2, "__mode");
+        lua_setmetatable(L, -2);
+
+        push_ids_key(L);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, LUA_REGISTRYINDEX);
+    }
     lua_newtable(L);
 
-    // put it at the bottom of the stack
-    lua_insert(L, 1);
+    m_strings.clear();
+    m_records.clear();
+    m_pending.clear();
+    ++m_snapshot;
+    uint32 first_string = m_next_string + 1;
+
+    BOStreamBE strings(&m_strings);
+    BOStreamBE records(&m_records);
+    Context c = {L, value + 1, value + 2, *this, strings, records};
 
-    uint32 counter = 0;
-    BOStreamBE s(sb);
     try {
-        s << kVersion;
-        save(L, s, counter);
+        save_value(c, value);
+
+        // m_pending grows as records reach more tables
+        for (size_t i = 0; i < m_pending.size(); ++i) {
+            uint32 id = m_pending[i];
+            lua_rawgeti(L, c.pending, static_cast<int>(i + 1));
+
+            size_t start = m_records.size();
+            records << id;
+
+            // write all k/v pairs
+            lua_pushnil(L);
+            while (lua_next(L, -2)) {
+                if (saveable(L, -2) && saveable(L, -1)) {
+                    save_value(c, -2);
+                    save_value(c, -1);
+                }
+                lua_pop(L, 1);
+            }
+            records << static_cast<int8>(LUA_TNIL);
+
+            // in a delta, leave out tables that are as they were last time
+            uint64_t hash = hash_bytes(m_records.data() + start, m_records.size() - start);
+            if (delta && m_tables[id - 1].hash == hash)
+                m_records.truncate(start);
+            m_tables[id - 1].hash = hash;
+
+            lua_pop(L, 1);
+        }
+        records << static_cast<uint32>(0);
+
+        BOStreamBE s(sb);
+        s << kVersion << static_cast<uint8>(delta ? 1 : 0) << first_string
+          << static_cast<uint32>(m_next_string + 1 - first_string);
+        s.write(m_strings.data(), m_strings.size());
+        s.write(m_records.data(), m_records.size());
     } catch (const basic_bstream::failure& e) {
         logWarning("failed to save Lua data; %s", e.what());
-        lua_settop(L, 0);
+        lua_settop(L, value);
+        reset(L);
         return false;
     }
 
-    // remove the reference table
-    lua_remove(L, 1);
+    lua_settop(L, value);
     return true;
 }
 
-static int restore(lua_State* L, BIStreamBE& s) {
+void LuaSnapshotWriter::reset(lua_State* L) {
+    push_ids_key(L);
+    lua_pushnil(L);
+    lua_rawset(L, LUA_REGISTRYINDEX);
+
+    m_next_table  = 0;
+    m_next_string = 0;
+    m_tables.clear();
+}
+
+// table id -> table, creating it if this is the first we've heard of it
+static void push_table(lua_State* L, int tables, uint32 id) {
+    lua_rawgeti(L, tables, id);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, tables, id);
+    }
+}
+
+static int restore_value(lua_State* L, BIStreamBE& s, int tables, int strings) {
+    int8 type;
+    s >> type;
+
+    switch (type) {
+        case LUA_TBOOLEAN: {
+            uint8 b;
+            s >> b;
+            lua_pushboolean(L, b == 1);
+        } break;
+        case LUA_TNUMBER: {
+            double d;
+            s >> d;
+            lua_pushnumber(L, static_cast<lua_Number>(d));
+        } break;
+        case LUA_TSTRING: {
+            uint32 id;
+            s >> id;
+            lua_rawgeti(L, strings, id);
+        } break;
+        case LUA_TTABLE: {
+            uint32 id;
+            s >> id;
+            push_table(L, tables, id);
+        } break;
+        case LUA_TUSERDATA: {
+            uint32 name, index;
+            s >> name >> index;
+
+            // get the metatable
+            lua_rawgeti(L, strings, name);
+            lua_gettable(L, LUA_REGISTRYINDEX);
+            // get the accessor we added
+            lua_getfield(L, -1, "__new");
+            if (lua_isfunction(L, -1)) {
+                lua_pushnumber(L, static_cast<lua_Number>(index));
+                lua_call(L, 1, 1);
+            }
+
+            lua_remove(L, -2);
+        } break;
+        default:
+            lua_pushnil(L);
+            break;
+    }
+
+    return type;
+}
+
+static int restore_v1(lua_State* L, BIStreamBE& s) {
     int8 type;
     s >> type;
 
@@ -180,16 +356,16 @@ static int restore(lua_State* L, BIStreamBE& s) {
             lua_pushvalue(L, -2);
             lua_rawset(L, 1);
 
-            int key_type = restore(L, s);
+            int key_type = restore_v1(L, s);
             while (key_type != LUA_TNIL) {
-                restore(L, s); // value
+                restore_v1(L, s); // value
                 if (lua_isnil(L, -2)) {
                     // maybe an invalid userdata?
                     lua_pop(L, 2);
                 } else {
                     lua_rawset(L, -3);
                 }
-                key_type = restore(L, s); // next key
+                key_type = restore_v1(L, s); // next key
             }
             lua_pop(L, 1);
         } break;
@@ -238,12 +414,9 @@ static int restore(lua_State* L, BIStreamBE& s) {
     return type;
 }
 
-bool lua_restore(lua_State* L, std::streambuf* sb) {
-    // create a reference table
-    lua_newtable(L);
-
-    // put it at the bottom of the stack
-    lua_insert(L, 1);
+bool LuaSnapshotReader::restore(lua_State* L, std::streambuf* sb) {
+    int top              = lua_gettop(L);
+    bool reference_table = false;
 
     BIStreamBE s(sb);
     try {
@@ -254,14 +427,124 @@ bool lua_restore(lua_State* L, std::streambuf* sb) {
             return false;
         }
 
-        restore(L, s);
+        if (version < 2) {
+            // create a reference table, at the bottom of the stack
+            lua_newtable(L);
+            lua_insert(L, 1);
+            reference_table = true;
+
+            restore_v1(L, s);
+
+            // remove the reference table
+            lua_remove(L, 1);
+            return true;
+        }
+
+        uint8 delta;
+        s >> delta;
+        if (!delta)
+            reset(L);
+
+        push_table_ids_key(L);
+        lua_rawget(L, LUA_REGISTRYINDEX);
+        push_string_ids_key(L);
+        lua_rawget(L, LUA_REGISTRYINDEX);
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 2);
+
+            lua_newtable(L);
+            push_table_ids_key(L);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, LUA_REGISTRYINDEX);
+
+            lua_newtable(L);
+            push_string_ids_key(L);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, LUA_REGISTRYINDEX);
+        }
+        int tables  = top + 1;
+        int strings = top + 2;
+
+        uint32 first_string, string_count;
+        s >> first_string >> string_count;
+        std::vector<char> v;
+        for (uint32 i = 0; i < string_count; ++i) {
+            uint32 length;
+            s >> length;
+            v.resize(length);
+            s.read(v.data(), length);
+            lua_pushlstring(L, v.data(), length);
+            lua_rawseti(L, strings, first_string + i);
+        }
+
+        restore_value(L, s, tables, strings);
+
+        uint32 id;
+        s >> id;
+        while (id) {
+            push_table(L, tables, id);
+
+            // a table's record has all of its contents
+            lua_pushnil(L);
+            while (lua_next(L, -2)) {
+                lua_pop(L, 1);
+                lua_pushvalue(L, -1);
+                lua_pushnil(L);
+                lua_rawset(L, -4);
+            }
+
+            while (restore_value(L, s, tables, strings) != LUA_TNIL) {
+                restore_value(L, s, tables, strings);
+                if (lua_isnil(L, -2) || lua_isnil(L, -1)) {
+                    // maybe an invalid userdata?
+                    lua_pop(L, 2);
+                } else {
+                    lua_rawset(L, -3);
+                }
+            }
+            lua_pop(L, 2); // the nil key, and the table
+
+            s >> id;
+        }
+
+        lua_remove(L, strings);
+        lua_remove(L, tables);
     } catch (const basic_bstream::failure& e) {
         logWarning("failed to restore Lua data; %s", e.what());
-        lua_settop(L, 0);
+        if (reference_table) {
+            lua_settop(L, top + 1);
+            lua_remove(L, 1);
+        }
+        lua_settop(L, top);
         return false;
     }
 
-    // remove the reference table
-    lua_remove(L, 1);
     return true;
 }
+
+void LuaSnapshotReader::reset(lua_State* L) {
+    push_table_ids_key(L);
+    lua_pushnil(L);
+    lua_rawset(L, LUA_REGISTRYINDEX);
+
+    push_string_ids_key(L);
+    lua_pushnil(L);
+    lua_rawset(L, LUA_REGISTRYINDEX);
+}
+
+bool lua_save(lua_State* L, std::streambuf* sb) {
+    // one writer for every save, so its buffers are only allocated once
+    static LuaSnapshotWriter writer;
+
+    bool saved = writer.save(L, sb, false);
+    writer.reset(L);
+    return saved;
+}
+
+bool lua_restore(lua_State* L, std::streambuf* sb) {
+    LuaSnapshotReader reader;
+
+    bool restored = reader.restore(L, sb);
+    reader.reset(L);
+    return restored;
+}
@@ -28,6 +28,7 @@
 #include "cseries.hpp"
 
 #include <streambuf>
+#include <vector>
 
 extern "C" {
 #include "lauxlib.h"
@@ -38,7 +39,93 @@ extern "C" {
 // saves object on top of the stack to s
 bool lua_save(lua_State* L, std::streambuf* sb);
 
-// restores object in s to top of the stack
+// restores object in s to top of the stack; on failure, leaves the stack as it was
 bool lua_restore(lua_State* L, std::streambuf* sb);
 
+// An output buffer that keeps its memory from one snapshot to the next
+class lua_arena_buffer : public std::streambuf {
+  public:
+
+    lua_arena_buffer() {}
+
+    const char* data() const { return pbase(); }
+
+    size_t size() const { return pptr() - pbase(); }
+
+    // forget everything from offset on
+    void truncate(size_t offset) {
+        setp(pbase(), epptr());
+        pbump(static_cast<int>(offset));
+    }
+
+    void clear() { truncate(0); }
+
+  protected:
+
+    int overflow(int ch) override;
+
+  private:
+
+    std::vector<char> m_storage;
+};
+
+// Writes successive snapshots of one value, keeping the ids of its tables and strings
+// between them; a delta snapshot only holds the tables whose contents changed since this
+// writer's previous snapshot, and can only be restored by a reader that restored all the
+// snapshots before it. Strings are never forgotten, so reset() now and then.
+class LuaSnapshotWriter {
+  public:
+
+    LuaSnapshotWriter() : m_next_table(0), m_next_string(0), m_snapshot(0) {}
+
+    // saves object on top of the stack to s; the first snapshot, and the first after a
+    // reset or a failure, is always a full one
+    bool save(lua_State* L, std::streambuf* sb, bool delta);
+
+    // the next snapshot will be a full one, with new ids
+    void reset(lua_State* L);
+
+  private:
+
+    struct TableState {
+        uint64_t hash;   // of its contents when last written
+        uint32 snapshot; // the last one that reached it
+    };
+
+    struct Context;
+    static uint32 string_id(Context& c, int index);
+    static uint32 table_id(Context& c, int index);
+    static void save_value(Context& c, int index);
+
+    // registry key for the ids of the tables and strings written so far
+    void push_ids_key(lua_State* L) { lua_pushlightuserdata(L, this); }
+
+    uint32 m_next_table;
+    uint32 m_next_string;
+    uint32 m_snapshot;
+    std::vector<TableState> m_tables; // by id
+    std::vector<uint32> m_pending;    // ids of the tables this snapshot has yet to write
+
+    lua_arena_buffer m_strings;
+    lua_arena_buffer m_records;
+};
+
+class LuaSnapshotReader {
+  public:
+
+    // restores object in s to top of the stack
+    bool restore(lua_State* L, std::streambuf* sb);
+
+    void reset(lua_State* L);
+
+  private:
+
+    // registry keys for the tables and strings restored so far, by id
+    void push_table_ids_key(lua_State* L) { lua_pushlightuserdata(L, &m_keys[0]); }
+
+    void push_string_ids_key(lua_State* L) { lua_pushlightuserdata(L, &m_keys[1]); }
+
+    char m_keys[2];
+};
+
 #endif
@@ -65,6 +65,31 @@ int L_TableFunction(lua_State* L) {
     return 1;
 }
 
+// Says whether an index refers to a valid object; property access checks this every
+// time, so it's a plain function pointer (or a range) rather than a std::function
+template <typename index_t>
+class L_Validator {
+  public:
+
+    typedef bool (*function_type)(index_t);
+
+    L_Validator(function_type function, int32 max_index = 0) : m_function(function), m_max(max_index) {}
+
+    bool operator()(index_t index) const {
+        return m_function ? m_function(index) : (index >= 0 && index < m_max);
+    }
+
+  private:
+
+    function_type m_function;
+    int32 m_max; // without a function, indices below this are valid
+};
+
+template <typename index_t>
+bool always_valid(index_t) {
+    return true;
+}
+
 template <char* name, typename index_t = int16>
 class L_Class {
   public:
@@ -82,14 +107,10 @@ class L_Class {
     static index_t Index(lua_State* L, int index);
     static bool Is(lua_State* L, int index);
     static void Invalidate(lua_State* L, index_t index);
-    static std::function<bool(index_t)> Valid;
-
-    struct ValidRange {
-        ValidRange(int32 max_index) : m_max(max_index) {}
+    static L_Validator<index_t> Valid;
 
-        bool operator()(int32 index) { return (index >= 0 && index < m_max); }
-
-        int32 m_max;
+    struct ValidRange : public L_Validator<index_t> {
+        ValidRange(int32 max_index) : L_Validator<index_t>(nullptr, max_index) {}
     };
 
     // ghs: codewarrior chokes on this:
@@ -109,7 +130,11 @@ class L_Class {
     template <typename instance_t /*L_Class or a derived class*/>
     static instance_t* NewInstance(lua_State* L, index_t index);
 
+    // __index and __newindex are closures over the get or set methods table (upvalue 1)
+    // and the metatable (upvalue 2), so neither needs a registry lookup
     static int _get(lua_State* L);
+    static void _push_get_closure(lua_State* L, lua_CFunction get);
+    static void _check_instance(lua_State* L, int index);
 
     // registry keys
     static void _push_get_methods_key(lua_State* L) { lua_pushlightuserdata(L, (void*)(&name[1])); }
@@ -122,12 +147,8 @@ class L_Class {
     static void _push_custom_fields_table(lua_State* L);
 };
 
-struct always_valid {
-    bool operator()(int32 x) { return true; }
-};
-
 template <char* name, typename index_t>
-std::function<bool(index_t)> L_Class<name, index_t>::Valid = always_valid();
+L_Validator<index_t> L_Class<name, index_t>::Valid = always_valid<index_t>;
 
 template <char* name, typename index_t>
 void L_Class<name, index_t>::Register(lua_State* L, const luaL_Reg get[], const luaL_Reg set[],
@@ -140,14 +161,6 @@ void L_Class<name, index_t>::Register(lua_State* L, const luaL_Reg get[], const
     lua_pushstring(L, name);
     lua_settable(L, LUA_REGISTRYINDEX);
 
-    // register metatable get
-    lua_pushcfunction(L, _get);
-    lua_setfield(L, -2, "__index");
-
-    // register metatable set
-    lua_pushcfunction(L, _set);
-    lua_setfield(L, -2, "__newindex");
-
     // register metatable tostring
     lua_pushcfunction(L, _tostring);
     lua_setfield(L, -2, "__tostring");
@@ -155,12 +168,6 @@ void L_Class<name, index_t>::Register(lua_State* L, const luaL_Reg get[], const
     lua_pushcfunction(L, _new);
     lua_setfield(L, -2, "__new");
 
-    if (metatable)
-        luaL_setfuncs(L, metatable, 0);
-
-    // clear the stack
-    lua_pop(L, 1);
-
     // register get methods
     _push_get_methods_key(L);
     lua_newtable(L);
@@ -173,6 +180,10 @@ void L_Class<name, index_t>::Register(lua_State* L, const luaL_Reg get[], const
         luaL_setfuncs(L, get, 0);
     lua_settable(L, LUA_REGISTRYINDEX);
 
+    // register metatable get
+    _push_get_closure(L, _get);
+    lua_setfield(L, -2, "__index");
+
     // register set methods
     _push_set_methods_key(L);
     lua_newtable(L);
@@ -181,6 +192,19 @@ void L_Class<name, index_t>::Register(lua_State* L, const luaL_Reg get[], const
         luaL_setfuncs(L, set, 0);
     lua_settable(L, LUA_REGISTRYINDEX);
 
+    // register metatable set
+    _push_set_methods_key(L);
+    lua_gettable(L, LUA_REGISTRYINDEX);
+    lua_pushvalue(L, -2);
+    lua_pushcclosure(L, _set, 2);
+    lua_setfield(L, -2, "__newindex");
+
+    if (metatable)
+        luaL_setfuncs(L, metatable, 0);
+
+    // clear the stack
+    lua_pop(L, 1);
+
     // register a table for instances
     _push_instances_key(L);
     lua_newtable(L);
@@ -323,11 +347,25 @@ int L_Class<name, index_t>::_is(lua_State* L) {
     return 1;
 }
 
+template <char* name, typename index_t>
+void L_Class<name, index_t>::_push_get_closure(lua_State* L, lua_CFunction get) {
+    _push_get_methods_key(L);
+    lua_gettable(L, LUA_REGISTRYINDEX);
+    luaL_getmetatable(L, name);
+    lua_pushcclosure(L, get, 2);
+}
+
+template <char* name, typename index_t>
+void L_Class<name, index_t>::_check_instance(lua_State* L, int index) {
+    if (!lua_getmetatable(L, index) || !lua_rawequal(L, -1, lua_upvalueindex(2)))
+        luaL_typerror(L, index, name);
+    lua_pop(L, 1);
+}
+
 template <char* name, typename index_t>
 int L_Class<name, index_t>::_get(lua_State* L) {
     if (lua_isstring(L, 2)) {
-        luaL_checktype(L, 1, LUA_TUSERDATA);
-        luaL_checkudata(L, 1, name);
+        _check_instance(L, 1);
         if (!Valid(Index(L, 1)) && strcmp(lua_tostring(L, 2), "valid") != 0 && strcmp(lua_tostring(L, 2), "index") != 0)
             luaL_error(L, "invalid object");
 
@@ -346,25 +384,15 @@ int L_Class<name, index_t>::_get(lua_State* L) {
 
             lua_remove(L, -2);
         } else {
-            // pop the get table
-            _push_get_methods_key(L);
-            lua_gettable(L, LUA_REGISTRYINDEX);
-
-            // get the function from that table
+            // get the function from the get table
             lua_pushvalue(L, 2);
-            lua_gettable(L, -2);
-            lua_remove(L, -2);
+            lua_rawget(L, lua_upvalueindex(1));
 
-            if (lua_isfunction(L, -1)) {
-                // execute the function with table as our argument
-                lua_pushvalue(L, 1);
-                if (lua_pcall(L, 1, 1, 0) == LUA_ERRRUN) {
-                    // report the error as being on this line
-                    luaL_where(L, 1);
-                    lua_pushvalue(L, -2);
-                    lua_concat(L, 2);
-                    lua_error(L);
-                }
+            if (lua_CFunction get = lua_tocfunction(L, -1)) {
+                // call it in place, with the object as its only argument; its errors
+                // are already reported as being on the script's line
+                lua_settop(L, 1);
+                return get(L);
             } else {
                 lua_pop(L, 1);
                 lua_pushnil(L);
@@ -391,8 +419,7 @@ int L_Class<name, index_t>::_new(lua_State* L) {
 
 template <char* name, typename index_t>
 int L_Class<name, index_t>::_set(lua_State* L) {
-    luaL_checktype(L, 1, LUA_TUSERDATA);
-    luaL_checkudata(L, 1, name);
+    _check_instance(L, 1);
 
     if (lua_isstring(L, 2) && lua_tostring(L, 2)[0] == '_') {
         _push_custom_fields_table(L);
@@ -420,30 +447,19 @@ int L_Class<name, index_t>::_set(lua_State* L) {
 
         lua_pop(L, 1);
     } else {
-        // pop the set table
-        _push_set_methods_key(L);
-        lua_gettable(L, LUA_REGISTRYINDEX);
-
-        // get the function from that table
+        // get the function from the set table
         lua_pushvalue(L, 2);
-        lua_gettable(L, -2);
+        lua_rawget(L, lua_upvalueindex(1));
 
-        if (lua_isnil(L, -1)) {
+        lua_CFunction set = lua_tocfunction(L, -1);
+        if (!set) {
             luaL_error(L, "no such index");
         }
 
-        // execute the function with table, value as our arguments
-        lua_pushvalue(L, 1);
-        lua_pushvalue(L, 3);
-        if (lua_pcall(L, 2, 0, 0) == LUA_ERRRUN) {
-            // report the error as being on this line
-            luaL_where(L, 1);
-            lua_pushvalue(L, -2);
-            lua_concat(L, 2);
-            lua_error(L);
-        }
-
-        lua_pop(L, 1);
+        // call it in place, with table, value as our arguments
+        lua_settop(L, 3);
+        lua_remove(L, 2);
+        set(L);
     }
 
     return 0;
@@ -724,7 +740,7 @@ void L_Container<name, T>::Register(lua_State* L, const luaL_Reg get[], const lu
     L_Class<name>::Register(L, get, set, metatable);
     luaL_getmetatable(L, name);
 
-    lua_pushcfunction(L, _get_container);
+    L_Class<name>::_push_get_closure(L, _get_container);
     lua_setfield(L, -2, "__index");
 
     lua_pushcfunction(L, _call);
@@ -805,7 +821,7 @@ void L_EnumContainer<name, T>::Register(lua_State* L, const luaL_Reg methods[],
 
     luaL_getmetatable(L, name);
 
-    lua_pushcfunction(L, _get_enumcontainer);
+    L_Class<name>::_push_get_closure(L, _get_enumcontainer);
     lua_setfield(L, -2, "__index");
 
     lua_pop(L, 1);
@@ -868,7 +884,7 @@ class L_ObjectClass : public L_Class<name, index_t> {
 
     static bool Is(lua_State* L, int index) { return L_Class<name, index_t>::Is(L, index); }
 
-    static std::function<bool(index_t)> Valid;
+    static L_Validator<index_t> Valid;
 
     static std::map<index_t, object_t> _objects;
 };
@@ -877,15 +893,13 @@ template <char* name, typename object_t, typename index_t>
 std::map<index_t, object_t> L_ObjectClass<name, object_t, index_t>::_objects;
 
 template <char* name, typename object_t, typename index_t>
-struct object_valid {
-    bool operator()(index_t x) {
-        return (L_ObjectClass<name, object_t, index_t>::_objects.find(x)
-                != L_ObjectClass<name, object_t, index_t>::_objects.end());
-    }
-};
+bool object_valid(index_t x) {
+    return (L_ObjectClass<name, object_t, index_t>::_objects.find(x)
+            != L_ObjectClass<name, object_t, index_t>::_objects.end());
+}
 
 template <char* name, typename object_t, typename index_t>
-std::function<bool(index_t)> L_ObjectClass<name, object_t, index_t>::Valid = object_valid<name, object_t, index_t>();
+L_Validator<index_t> L_ObjectClass<name, object_t, index_t>::Valid = object_valid<name, object_t, index_t>;
 
 template <char* name, typename object_t, typename index_t>
 template <typename instance_t>
@@ -425,6 +425,24 @@ void initialize_application(void) {
         graphics_preferences->screen_mode.fullscreen = false;
     write_preferences();
 
+    if (!shell_options.export_film.empty()) {
+        if (shell_options.nosound) {
+            fprintf(stderr, "--export can't be used with --nosound; the movie's audio comes from the mixer\n");
+            exit(1);
+        }
+
+        // film export runs as fast as it can render, so it doesn't wait for the display (see
+        // screen.cpp); the frame-rate target only applies to this session, and isn't saved
+        if (!shell_options.export_fps.empty()) {
+            int fps = atoi(shell_options.export_fps.c_str());
+            if (fps < 30 || fps % 30 || fps > INT16_MAX) {
+                fprintf(stderr, "--export-fps must be a multiple of 30\n");
+                exit(1);
+            }
+            session_fps_target = static_cast<int16>(fps);
+        }
+    }
+
     Plugins::instance()->load_mml(true);
 
     //	SDL_WM_SetCaption(application_name, application_name);
@@ -480,6 +498,7 @@ void initialize_application(void) {
 }
 
 void shutdown_application(void) {
+    finish_saved_games(true);
     WadImageCache::instance()->save_cache();
 
     shutdown_dialogs();
@@ -687,7 +706,7 @@ void main_event_loop(void) {
             fps_target = 30;
         }
 
-        if (game_state == _game_in_progress && fps_target != 0) {
+        if (game_state == _game_in_progress && fps_target != 0 && shell_options.export_film.empty()) {
             int elapsed_machine_ticks         = machine_tick_count() - cur_time;
             int desired_elapsed_machine_ticks = MACHINE_TICKS_PER_SECOND / fps_target;
 
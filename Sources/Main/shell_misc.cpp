@@ -30,6 +30,7 @@ bool chat_input_mode = false;
 #include "Music.hpp"
 #include "TextStrings.hpp"
 #include "XML_ParseTreeRoot.hpp"
+#include "game_wad.hpp"
 #include "interface.hpp"
 #include "items.hpp"
 #include "map.hpp"
@@ -58,6 +59,7 @@ extern void update_interface(short time_elapsed);
 void global_idle_proc(void) {
     Music::instance()->Idle();
     SoundManager::instance()->Idle();
+    finish_saved_games();
 }
 
 /*
@@ -121,6 +121,8 @@ static const std::vector<ShellOptionsFlag> shell_options_flags{
 static const std::vector<ShellOptionsString> shell_options_strings{
         {"o",                            "output",           "With -e, output to [file] and exit on quit", shell_options.output          },
         {"l",                            "replay-directory", "Directory with replays to load",             shell_options.replay_directory},
+        {"x",                            "export",           "Export the film given to [file] and exit",   shell_options.export_film     },
+        {"",                             "export-fps",       "With -x, video frame rate (multiple of 30)", shell_options.export_fps      },
         {"NSDocumentRevisionsDebugMode", "",                 "",                                           ignore                        }  // annoying Xcode argument
 };
 
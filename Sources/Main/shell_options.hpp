@@ -46,9 +46,13 @@ struct ShellOptions {
 
     bool skip_intro;
     bool editor;
+    bool headless; // never draw the game world (set by tools that only simulate)
 
     std::string replay_directory;
 
+    std::string export_film; // render the film given to this movie file, as fast as possible, then quit
+    std::string export_fps;
+
     std::string directory;
     std::vector<std::string> files;
 
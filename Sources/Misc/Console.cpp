@@ -41,6 +41,9 @@
 #include "FileHandler.hpp"
 #include "game_wad.hpp"
 
+#include "Tracing.hpp"
+#include "lua_profiler.hpp"
+
 using namespace std;
 
 extern bool game_is_networked;
@@ -49,6 +52,8 @@ Console::Console() : m_active(false), m_carnage_messages_exist(false), m_use_lua
     m_command_iter = m_prev_commands.end();
     m_carnage_messages.resize(NUMBER_OF_PROJECTILE_TYPES);
     register_save_commands();
+    register_trace_commands();
+    register_lua_profile_commands();
 }
 
 Console* Console::instance() {
@@ -405,6 +410,92 @@ void Console::register_save_commands() {
 
 void Console::clear_saves() { last_level.clear(); }
 
+extern DirectorySpecifier log_dir;
+
+#ifdef AB_TRACING
+
+struct save_trace {
+    void operator()(const std::string& arg) const {
+        FileSpecifier fs  = log_dir;
+        fs               += arg == "" ? "trace.json" : arg;
+        if (Tracer::instance()->write_chrome_trace(fs.GetPath()))
+            screen_printf("Saved %s", utf8_to_mac_roman(fs.GetPath()).c_str());
+        else
+            screen_printf("An error occurred while saving the trace");
+    }
+};
+
+struct toggle_trace_overlay {
+    void operator()(const std::string&) const {
+        Tracer::instance()->set_overlay_visible(!Tracer::instance()->overlay_visible());
+    }
+};
+
+void Console::register_trace_commands() {
+    CommandParser traceParser;
+    traceParser.register_command("save", save_trace());
+    traceParser.register_command("show", toggle_trace_overlay());
+    register_command("trace", traceParser);
+}
+#else
+void Console::register_trace_commands() {}
+#endif
+
+struct start_lua_profile {
+    void operator()(const std::string&) const {
+        LuaProfiler::instance()->start();
+        screen_printf("Lua profiler started");
+    }
+};
+
+struct stop_lua_profile {
+    void operator()(const std::string&) const {
+        LuaProfiler::instance()->stop();
+        screen_printf("Lua profiler stopped");
+    }
+};
+
+struct reset_lua_profile {
+    void operator()(const std::string&) const { LuaProfiler::instance()->reset(); }
+};
+
+struct show_lua_profile {
+    void operator()(const std::string&) const {
+        // the two slowest triggers and hottest functions fill the screen messages
+        for (const auto& line : LuaProfiler::instance()->report(2)) screen_printf("%s", line.c_str());
+    }
+};
+
+struct save_lua_profile {
+    void operator()(const std::string& arg) const {
+        FileSpecifier fs  = log_dir;
+        fs               += arg == "" ? "lua_profile.txt" : arg;
+        if (LuaProfiler::instance()->write_report(fs.GetPath()))
+            screen_printf("Saved %s", utf8_to_mac_roman(fs.GetPath()).c_str());
+        else
+            screen_printf("An error occurred while saving the Lua profile");
+    }
+};
+
+struct set_lua_profile_budget {
+    void operator()(const std::string& arg) const {
+        if (arg != "")
+            LuaProfiler::instance()->set_budget(atof(arg.c_str()));
+        screen_printf("Lua trigger budget is %.3f ms", LuaProfiler::instance()->budget());
+    }
+};
+
+void Console::register_lua_profile_commands() {
+    CommandParser profileParser;
+    profileParser.register_command("start", start_lua_profile());
+    profileParser.register_command("stop", stop_lua_profile());
+    profileParser.register_command("reset", reset_lua_profile());
+    profileParser.register_command("show", show_lua_profile());
+    profileParser.register_command("save", save_lua_profile());
+    profileParser.register_command("budget", set_lua_profile_budget());
+    register_command("luaprofile", profileParser);
+}
+
 void reset_mml_console() {
     Console* console = Console::instance();
     console->use_lua_console(true);
@@ -119,6 +119,8 @@ class Console : public CommandParser {
     bool m_use_lua_console;
 
     void register_save_commands();
+    void register_trace_commands();
+    void register_lua_profile_commands();
 };
 
 class InfoTree;
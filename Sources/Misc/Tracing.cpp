@@ -0,0 +1,141 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "Tracing.hpp"
+
+#ifdef AB_TRACING
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+
+Tracer* Tracer::instance() {
+    static Tracer* instance_ = nullptr;
+    if (!instance_)
+        instance_ = new Tracer();
+    return instance_;
+}
+
+Tracer::Tracer()
+    : _entries(kEntryCount), _current(0), _last_tick(NONE), _epoch(clock::now()), _overlay_visible(false) {
+    for (auto& entry : _entries) entry.kind = _unused;
+}
+
+Tracer::Entry& Tracer::begin_entry(Kind kind, int32 tick) {
+    _current = (_current + 1) % kEntryCount;
+
+    // clear() keeps the capacity, so a warmed-up tracer doesn't allocate
+    Entry& entry  = _entries[_current];
+    entry.kind    = kind;
+    entry.tick    = tick;
+    entry.dropped = 0;
+    entry.events.clear();
+    return entry;
+}
+
+void Tracer::begin_tick(int32 tick, bool predicted) {
+    begin_entry(predicted ? _predicted_tick : _world_tick, tick);
+    if (!predicted)
+        _last_tick = tick;
+}
+
+void Tracer::begin_frame() { begin_entry(_frame, _last_tick); }
+
+void Tracer::record(const char* name, clock::time_point start, clock::time_point end) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    Entry& entry = _entries[_current];
+    if (entry.events.size() >= kEventsPerEntry) {
+        ++entry.dropped;
+        return;
+    }
+
+    entry.events.push_back({name, duration_cast<microseconds>(start - _epoch).count(),
+                            duration_cast<microseconds>(end - start).count()});
+}
+
+std::vector<std::pair<const char*, double>> Tracer::averages(int tick_count) const {
+    std::map<const char*, int64_t> totals;
+    int ticks_seen = 0;
+
+    for (int i = 0; i < kEntryCount && ticks_seen < tick_count; ++i) {
+        const Entry& entry = _entries[(_current - i + kEntryCount) % kEntryCount];
+        if (entry.kind == _unused)
+            break;
+
+        for (const auto& event : entry.events) totals[event.name] += event.duration;
+        if (entry.kind == _world_tick)
+            ++ticks_seen;
+    }
+
+    // nothing to average over while paused
+    std::vector<std::pair<const char*, double>> results;
+    if (!ticks_seen)
+        return results;
+
+    for (const auto& total : totals) results.push_back({total.first, total.second / 1000.0 / ticks_seen});
+    std::sort(results.begin(), results.end(),
+              [](const std::pair<const char*, double>& a, const std::pair<const char*, double>& b) {
+                  return a.second > b.second;
+              });
+
+    return results;
+}
+
+bool Tracer::write_chrome_trace(const std::string& path) const {
+#ifdef __WIN32__
+    FILE* file = _wfopen(utf8_to_wide(path).c_str(), L"w");
+#else
+    FILE* file = fopen(path.c_str(), "w");
+#endif
+    if (!file)
+        return false;
+
+    static const char* kind_names[] = {"unused", "tick", "predicted tick", "frame"};
+
+    // oldest entry first; every event is a "complete" event on one thread
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (int i = 1; i <= kEntryCount; ++i) {
+        const Entry& entry = _entries[(_current + i) % kEntryCount];
+        if (entry.kind == _unused)
+            continue;
+
+        for (const auto& event : entry.events) {
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":1,"
+                          "\"args\":{\"tick\":%d,\"kind\":\"%s\",\"dropped\":%d}}",
+                    first ? "" : ",\n", event.name, static_cast<long long>(event.start),
+                    static_cast<long long>(event.duration), static_cast<int>(entry.tick), kind_names[entry.kind],
+                    entry.dropped);
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    return fclose(file) == 0;
+}
+
+#endif // AB_TRACING
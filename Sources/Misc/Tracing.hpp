@@ -0,0 +1,138 @@
+#ifndef _TRACING_
+#define _TRACING_
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  Timing of the game loop, one ring buffer entry per world tick, predicted tick or
+ *  rendered frame
+ *
+ *  Wrap hot spots in TRACE_SCOPE("name"); the last few seconds of entries can be saved
+ *  as Chrome trace JSON ("trace save" in the console, open with chrome://tracing or
+ *  Perfetto) or summarized on screen ("trace show"). Everything compiles away unless
+ *  AB_TRACING is defined (configure --enable-tracing).
+ */
+
+#include "cseries.hpp"
+
+#ifdef AB_TRACING
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Tracer {
+  public:
+
+    typedef std::chrono::steady_clock clock;
+
+    static Tracer* instance();
+
+    // Events from now on belong to this world tick, real or predicted; recycles the oldest entry
+    void begin_tick(int32 tick, bool predicted);
+
+    // Events from now on belong to a rendered frame, so drawing (or a paused game) doesn't
+    // pile up in the last world tick
+    void begin_frame();
+
+    // name must outlive the tracer (a string literal); dropped past kEventsPerEntry
+    void record(const char* name, clock::time_point start, clock::time_point end);
+
+    // Time per name, in milliseconds per tick, over the last tick_count real world ticks and
+    // everything (predictions, frames) recorded between them; slowest first
+    std::vector<std::pair<const char*, double>> averages(int tick_count) const;
+
+    bool write_chrome_trace(const std::string& path) const;
+
+    bool overlay_visible() const { return _overlay_visible; }
+
+    void set_overlay_visible(bool visible) { _overlay_visible = visible; }
+
+  private:
+
+    Tracer();
+
+    struct Event {
+        const char* name;
+        int64_t start;    // microseconds since the tracer was created
+        int64_t duration; // microseconds
+    };
+
+    enum Kind {
+        _unused,
+        _world_tick,
+        _predicted_tick,
+        _frame
+    };
+
+    struct Entry {
+        Kind kind;
+        int32 tick; // the world tick, or the last one begun for a frame
+        int dropped;
+        std::vector<Event> events;
+    };
+
+    static const int kEntryCount     = 600; // ten seconds of game time, rendered at 30 fps
+    static const int kEventsPerEntry = 128;
+
+    Entry& begin_entry(Kind kind, int32 tick);
+
+    std::vector<Entry> _entries;
+    int _current;
+    int32 _last_tick;
+    clock::time_point _epoch;
+    bool _overlay_visible;
+};
+
+class TraceScope {
+  public:
+
+    explicit TraceScope(const char* name) : _name(name), _start(Tracer::clock::now()) {}
+
+    ~TraceScope() { Tracer::instance()->record(_name, _start, Tracer::clock::now()); }
+
+  private:
+
+    const char* _name;
+    Tracer::clock::time_point _start;
+};
+
+#define TRACE_CONCATENATE_(a, b)    a##b
+#define TRACE_CONCATENATE(a, b)     TRACE_CONCATENATE_(a, b)
+#define TRACE_SCOPE(name)           TraceScope TRACE_CONCATENATE(trace_scope_, __LINE__)(name)
+#define TRACE_TICK(tick, predicted) Tracer::instance()->begin_tick(tick, predicted)
+#define TRACE_FRAME()               Tracer::instance()->begin_frame()
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_TICK(tick, predicted)
+#define TRACE_FRAME()
+
+#endif // AB_TRACING
+
+#endif
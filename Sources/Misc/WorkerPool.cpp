@@ -0,0 +1,103 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+#include "WorkerPool.hpp"
+
+WorkerPool::WorkerPool(int thread_count)
+    : _job(nullptr), _count(0), _next(0), _done(0), _busy(0), _generation(0), _quit(false) {
+    for (int i = 0; i < thread_count; ++i) _threads.emplace_back(&WorkerPool::thread_loop, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _start.notify_all();
+    for (auto& thread : _threads) thread.join();
+}
+
+int WorkerPool::default_thread_count() {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void WorkerPool::run(int count, const std::function<void(int)>& job) {
+    if (_threads.empty() || count <= 1) {
+        for (int i = 0; i < count; ++i) job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job   = &job;
+        _count = count;
+        _next  = 0;
+        _done  = 0;
+        _busy  = static_cast<int>(_threads.size());
+        ++_generation;
+    }
+    _start.notify_all();
+
+    work(job, count);
+
+    // wait for the last index, and for every thread to let go of the job
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finish.wait(lock, [this] { return _done == _count && _busy == 0; });
+    _job = nullptr;
+}
+
+void WorkerPool::work(const std::function<void(int)>& job, int count) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_next < count) {
+        int index = _next++;
+        lock.unlock();
+        job(index);
+        lock.lock();
+        ++_done;
+    }
+}
+
+void WorkerPool::thread_loop() {
+    int generation = 0;
+    while (true) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _start.wait(lock, [&] { return _quit || _generation != generation; });
+        if (_quit)
+            return;
+
+        generation = _generation;
+        auto job   = _job;
+        int count  = _count;
+        lock.unlock();
+
+        work(*job, count);
+
+        lock.lock();
+        --_busy;
+        lock.unlock();
+        _finish.notify_one();
+    }
+}
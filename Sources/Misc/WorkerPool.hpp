@@ -0,0 +1,78 @@
+#ifndef _WORKER_POOL_
+#define _WORKER_POOL_
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+
+/*
+ *  A few threads that split up one job at a time
+ *
+ *  run() calls a job once for every index in [0, count), on the pool's threads and on
+ *  the calling thread, and returns when all of them are done. Jobs must not call run()
+ *  on the same pool.
+ */
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+  public:
+
+    // A pool with no threads of its own runs every job on the caller's thread
+    explicit WorkerPool(int thread_count);
+    ~WorkerPool();
+
+    // Threads that can work on a job at once, counting the caller's
+    int concurrency() const { return static_cast<int>(_threads.size()) + 1; }
+
+    void run(int count, const std::function<void(int)>& job);
+
+    // One thread for every core but the caller's
+    static int default_thread_count();
+
+  private:
+
+    void thread_loop();
+    void work(const std::function<void(int)>& job, int count);
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _finish;
+
+    const std::function<void(int)>* _job;
+    int _count;
+    int _next; // next index to hand out
+    int _done; // indices finished
+    int _busy; // pool threads still inside the current job
+    int _generation;
+    bool _quit;
+};
+
+#endif
@@ -25,8 +25,9 @@
 #include "game_errors.hpp"
 #include "cseries.hpp"
 
-static short last_type  = systemError;
-static short last_error = 0;
+// per thread, so that files written in the background report their own errors
+static thread_local short last_type  = systemError;
+static thread_local short last_error = 0;
 
 void set_game_error(short type, short error_code) {
     assert(type >= 0 && type < NUMBER_OF_TYPES);
@@ -96,11 +96,12 @@ enum recording_version {
     RECORDING_VERSION_ALEPH_ONE_1_2     = 9,
     RECORDING_VERSION_ALEPH_ONE_1_3     = 10,
     RECORDING_VERSION_ALEPH_ONE_1_4     = 11,
-    RECORDING_VERSION_ALEPH_ONE_1_7     = 12
+    RECORDING_VERSION_ALEPH_ONE_1_7     = 12,
+    RECORDING_VERSION_ALEPH_BET_0_9     = 13
 };
 
-const short default_recording_version = RECORDING_VERSION_ALEPH_ONE_1_7;
-const short max_handled_recording     = RECORDING_VERSION_ALEPH_ONE_1_7;
+const short default_recording_version = RECORDING_VERSION_ALEPH_BET_0_9;
+const short max_handled_recording     = RECORDING_VERSION_ALEPH_BET_0_9;
 
 #include "interface_menus.hpp"
 #include "screen_definitions.hpp"
@@ -936,7 +937,10 @@ bool idle_game_state(uint32 time) {
         short ticks_elapsed                    = theUpdateResult.second;
         bool redraw                            = false;
 
-        if (get_keyboard_controller_status()) {
+        if (shell_options.headless) {
+            // nothing to draw, but the heartbeat still waits for a first frame before running ahead
+            first_frame_rendered = ticks_elapsed > 0;
+        } else if (get_keyboard_controller_status()) {
             // ZZZ: I don't know for sure that render_screen works best with the number of _real_
             // ticks elapsed rather than the number of (potentially predictive) ticks elapsed.
             // This is a guess.
@@ -1766,6 +1770,8 @@ static bool begin_game(short user, bool cheat) {
                 case _replay_from_file:
                     success = setup_for_replay_from_file(DraggedReplayFile, get_current_map_checksum());
                     user    = _replay;
+                    if (success && !shell_options.export_film.empty())
+                        Movie::instance()->StartRecording(shell_options.export_film);
                     break;
 
                 default:
@@ -1808,6 +1814,9 @@ static bool begin_game(short user, bool cheat) {
                             load_film_profile(FILM_PROFILE_ALEPH_ONE_1_4);
                             break;
                         case RECORDING_VERSION_ALEPH_ONE_1_7:
+                            load_film_profile(FILM_PROFILE_ALEPH_ONE_1_7);
+                            break;
+                        case RECORDING_VERSION_ALEPH_BET_0_9:
                             load_film_profile(FILM_PROFILE_DEFAULT);
                             break;
                         default:
@@ -1957,6 +1966,7 @@ static void start_game(short user, bool changing_level) {
 
     // ZZZ: If it's a netgame, we want prediction; else no.
     set_prediction_wanted(user == _network_player);
+    set_rollback_wanted(user == _network_player && NetRollbackWanted());
 
     game_state.state              = _game_in_progress;
     game_state.current_screen     = 0;
@@ -2071,7 +2081,7 @@ static void finish_game(bool return_to_main_menu) {
 #endif // !defined(DISABLE_NETWORKING)
 
         if (game_state.user == _replay) {
-            if (!shell_options.replay_directory.empty()) {
+            if (!shell_options.replay_directory.empty() || !shell_options.export_film.empty()) {
                 game_state.state    = _quit_game;
                 return_to_main_menu = false;
             } else if (!(dynamic_world->game_information.game_type == _game_of_kill_monsters
@@ -2087,7 +2097,8 @@ static void finish_game(bool return_to_main_menu) {
     set_current_player_index(NONE);
 
     load_environment_from_preferences();
-    if ((game_state.user == _replay && shell_options.replay_directory.empty()) || game_state.user == _demo) {
+    if ((game_state.user == _replay && shell_options.replay_directory.empty() && shell_options.export_film.empty())
+        || game_state.user == _demo) {
         Plugins::instance()->set_mode(Plugins::kMode_Menu);
     }
     if (return_to_main_menu)
@@ -113,6 +113,8 @@ struct input_preferences_data* input_preferences             = NULL;
 SoundManager::Parameters* sound_preferences                  = NULL;
 struct environment_preferences_data* environment_preferences = NULL;
 
+int16 session_fps_target = NONE;
+
 // LP: fake portable-files stuff
 inline short memory_error() { return 0; }
 
@@ -3881,6 +3883,7 @@ InfoTree sound_preferences_tree() {
     root.put_attr("samples", sound_preferences->samples);
     root.put_attr("video_export_volume_db", sound_preferences->video_export_volume_db);
     root.put_attr("channel", static_cast<int>(sound_preferences->channel_type));
+    root.put_attr("cache_mb", sound_preferences->cache_mb);
 
     return root;
 }
@@ -5039,6 +5042,7 @@ void parse_sound_preferences(InfoTree root, std::string version) {
     root.read_attr("rate", sound_preferences->rate);
     root.read_attr("samples", sound_preferences->samples);
     root.read_attr("video_export_volume_db", sound_preferences->video_export_volume_db);
+    root.read_attr("cache_mb", sound_preferences->cache_mb);
 
     int channel_type = 0;
     root.read_attr("channel", channel_type);
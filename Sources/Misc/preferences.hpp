@@ -268,7 +268,12 @@ void read_preferences();
 void handle_preferences(void);
 void write_preferences(void);
 
-static inline int16 get_fps_target() { return graphics_preferences->fps_target; }
+// the frame-rate target for this session only, never saved; NONE to use the preference
+extern int16 session_fps_target;
+
+static inline int16 get_fps_target() {
+    return session_fps_target != NONE ? session_fps_target : graphics_preferences->fps_target;
+}
 
 void transition_preferences(const DirectorySpecifier& legacy_prefs_dir);
 
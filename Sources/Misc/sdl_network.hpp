@@ -114,6 +114,14 @@ void NetDDPDisposeFrame(DDPFramePtr frame);
 
 OSErr NetDDPSendFrame(DDPFramePtr frame, const NetAddrBlock* address, short protocolType, short socket);
 
+// Delay (in ms) or drop (with the given percent chance) every packet we receive from now on;
+// zeroes turn this off.  For testing, e.g. against a hub on the same machine.
+void NetDDPSetSimulatedConditions(int32 inLatency, int32 inLossPercent);
+
+// Run the packet handler on everything received so far; call with the mytm mutex held.
+// The receiving thread does this itself whenever it can get the mutex right away.
+void NetDDPDeliverPendingPackets(void);
+
 /* ---------- prototypes/NETWORK_ADSP.C */
 
 // jkvw: removed - we use TCPMess now
@@ -37,7 +37,7 @@ enum class StandaloneHubState {
 
 extern DirectorySpecifier log_dir;
 
-static void initialize_hub(short port) {
+static void initialize_hub(uint16_t port) {
     InitDefaultStringSets();
     log_dir                            = get_data_path(kPathLogs);
     network_preferences                = new network_preferences_data;
@@ -197,8 +197,8 @@ static uint16_t parse_port(char* port_arg) {
 }
 
 int main(int argc, char** argv) {
-    auto code  = 0;
-    short port = 0;
+    auto code     = 0;
+    uint16_t port = 0;
 
     if (argc > 1) {
         port = parse_port(argv[1]);
@@ -2785,4 +2785,10 @@ void NetUpdateUnconfirmedActionFlags() {
     return sCurrentGameProtocol->UpdateUnconfirmedActionFlags();
 }
 
+extern bool spoke_wants_rollback();
+
+bool NetRollbackWanted() {
+    return sCurrentGameProtocol == static_cast<NetworkGameProtocol*>(&sStarGameProtocol) && spoke_wants_rollback();
+}
+
 #endif // !defined(DISABLE_NETWORKING)
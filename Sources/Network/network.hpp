@@ -300,6 +300,8 @@ bool NetAllowSavingLevel();
 int32 NetGetUnconfirmedActionFlagsCount();        // how many flags can we use for prediction?
 uint32 NetGetUnconfirmedActionFlag(int32 offset); // offset < GetUnconfirmedActionFlagsCount
 void NetUpdateUnconfirmedActionFlags();
+// predicted ticks should simulate everything they can undo (weapons and all), not just movement
+bool NetRollbackWanted();
 
 struct NetworkStats {
     enum {
@@ -64,3 +64,5 @@ bool NetAllowBehindview(void) { return false; }
 bool NetAllowCrosshair(void) { return false; }
 
 bool NetAllowTunnelVision(void) { return false; }
+
+bool NetRollbackWanted(void) { return false; }
@@ -156,6 +156,7 @@ struct HubPreferences {
     int32 mRecoverySendPeriod;
     int32 mMinimumSendPeriod;
     bool mBandwidthReduction;
+    bool mRollback; // make up flags for laggards like mBandwidthReduction; spokes predict and correct
 };
 
 static HubPreferences sHubPreferences;
@@ -1189,6 +1190,9 @@ static void make_player_netdead(int inPlayerIndex) {
 static int add_squares(int x, int y) { return x + y * y; }
 
 static bool hub_tick() {
+    // packets that arrived while we (or someone else) had the mutex
+    NetDDPDeliverPendingPackets();
+
     sNetworkTicker++;
 
     logContextNMT("performing hub_tick %d", sNetworkTicker);
@@ -1222,7 +1226,8 @@ static bool hub_tick() {
 
     // if we're getting behind, make up flags
 
-    if (sHubPreferences.mBandwidthReduction && sPlayerDataDisposition.getReadTick() >= sSmallestRealGameTick) {
+    if ((sHubPreferences.mBandwidthReduction || sHubPreferences.mRollback)
+        && sPlayerDataDisposition.getReadTick() >= sSmallestRealGameTick) {
         if (sHubPreferences.mMinimumSendPeriod >= sHubPreferences.mSendPeriod
             && sSmallestIncompleteTick < sPlayerDataDisposition.getWriteTick()) {
 
@@ -1588,6 +1593,7 @@ void HubParsePreferencesTree(InfoTree prefs, std::string version) {
     }
 
     prefs.read_attr("use_bandwidth_reduction", sHubPreferences.mBandwidthReduction);
+    prefs.read_attr("use_rollback", sHubPreferences.mRollback);
 
 
     // The checks above are not sufficient to catch all bad cases; if user specified a window size
@@ -1616,6 +1622,7 @@ InfoTree HubPreferencesTree() {
 
     for (size_t i = 0; i < kNumAttributes; ++i) root.put_attr(sAttributeStrings[i], *(sAttributeDestinations[i]));
     root.put_attr("use_bandwidth_reduction", sHubPreferences.mBandwidthReduction);
+    root.put_attr("use_rollback", sHubPreferences.mRollback);
 
     return root;
 }
@@ -1623,6 +1630,7 @@ InfoTree HubPreferencesTree() {
 void DefaultHubPreferences() {
     for (size_t i = 0; i < kNumAttributes; i++) *(sAttributeDestinations[i]) = sDefaultHubPreferences[i];
     sHubPreferences.mBandwidthReduction = true;
+    sHubPreferences.mRollback           = false;
     /*
         sHubPreferences.mPregameWindowSize = kDefaultPregameWindowSize;
         sHubPreferences.mInGameWindowSize = kDefaultInGameWindowSize;
@@ -64,7 +64,10 @@ struct SpokePreferences {
     int32 mRecoverySendPeriod;
     int32 mTimingWindowSize;
     int32 mTimingNthElement;
+    int32 mSimulatedLatency;
+    int32 mSimulatedLossPercent;
     bool mAdjustTiming;
+    bool mRollback;
 };
 
 static SpokePreferences sSpokePreferences;
@@ -250,6 +253,8 @@ void spoke_initialize(const NetAddrBlock& inHubAddress, int32 inFirstTick, size_
     sDisplayLatencyTicks = 0;
 
     sHeardFromHub = false;
+
+    NetDDPSetSimulatedConditions(sSpokePreferences.mSimulatedLatency, sSpokePreferences.mSimulatedLossPercent);
 }
 
 void spoke_cleanup(bool inGraceful) {
@@ -279,6 +284,8 @@ void spoke_cleanup(bool inGraceful) {
     sDisplayLatencyBuffer.clear();
     NetDDPDisposeFrame(sOutgoingFrame);
     sOutgoingFrame = NULL;
+
+    NetDDPSetSimulatedConditions(0, 0);
 }
 
 int32 spoke_get_net_time() {
@@ -777,6 +784,9 @@ static void process_optional_message(AIStream& ps, IncomingGameDataPacketProcess
 }
 
 static bool spoke_tick() {
+    // packets that arrived while we (or someone else) had the mutex
+    NetDDPDeliverPendingPackets();
+
     logContextNMT("processing spoke_tick %d", sNetworkTicker);
 
     sNetworkTicker++;
@@ -1001,6 +1011,8 @@ TickBasedActionQueue* spoke_get_unconfirmed_flags_queue() { return &sUnconfirmed
 
 int32 spoke_get_smallest_unconfirmed_tick() { return sSmallestUnconfirmedTick; }
 
+bool spoke_wants_rollback() { return sSpokePreferences.mRollback; }
+
 enum {
     kPregameTicksBeforeNetDeathAttribute,
     kInGameTicksBeforeNetDeathAttribute,
@@ -1008,6 +1020,8 @@ enum {
     kRecoverySendPeriodAttribute,
     kTimingWindowSizeAttribute,
     kTimingNthElementAttribute,
+    kSimulatedLatencyAttribute,
+    kSimulatedLossAttribute,
     kNumInt32Attributes,
     kAdjustTimingAttribute = kNumInt32Attributes,
     kNumAttributes
@@ -1016,13 +1030,14 @@ enum {
 static const char* sAttributeStrings[kNumInt32Attributes]
         = {"pregame_ticks_before_net_death", "ingame_ticks_before_net_death",
            //	"outgoing_flags_queue_size",
-           "recovery_send_period", "timing_window_size", "timing_nth_element"};
+           "recovery_send_period", "timing_window_size", "timing_nth_element", "simulated_latency", "simulated_loss"};
 
 static int32* sAttributeDestinations[kNumInt32Attributes]
         = {&sSpokePreferences.mPregameTicksBeforeNetDeath, &sSpokePreferences.mInGameTicksBeforeNetDeath,
            //	&sSpokePreferences.mOutgoingFlagsQueueSize,
            &sSpokePreferences.mRecoverySendPeriod, &sSpokePreferences.mTimingWindowSize,
-           &sSpokePreferences.mTimingNthElement};
+           &sSpokePreferences.mTimingNthElement, &sSpokePreferences.mSimulatedLatency,
+           &sSpokePreferences.mSimulatedLossPercent};
 
 void SpokeParsePreferencesTree(InfoTree prefs, std::string version) {
     for (size_t i = 0; i < kNumInt32Attributes; ++i) {
@@ -1037,6 +1052,8 @@ void SpokeParsePreferencesTree(InfoTree prefs, std::string version) {
                     min = 1;
                     break;
                 case kTimingNthElementAttribute:
+                case kSimulatedLatencyAttribute:
+                case kSimulatedLossAttribute:
                     min = 0;
                     break;
             }
@@ -1049,6 +1066,7 @@ void SpokeParsePreferencesTree(InfoTree prefs, std::string version) {
     }
 
     prefs.read_attr("adjust_timing", sSpokePreferences.mAdjustTiming);
+    prefs.read_attr("use_rollback", sSpokePreferences.mRollback);
 
 
     // The checks above are not sufficient to catch all bad cases; if user specified a window size
@@ -1068,6 +1086,7 @@ InfoTree SpokePreferencesTree() {
 
     for (size_t i = 0; i < kNumInt32Attributes; ++i) root.put_attr(sAttributeStrings[i], *(sAttributeDestinations[i]));
     root.put_attr("adjust_timing", sSpokePreferences.mAdjustTiming);
+    root.put_attr("use_rollback", sSpokePreferences.mRollback);
 
     return root;
 }
@@ -1076,10 +1095,13 @@ void DefaultSpokePreferences() {
     sSpokePreferences.mPregameTicksBeforeNetDeath = kDefaultPregameTicksBeforeNetDeath;
     sSpokePreferences.mInGameTicksBeforeNetDeath  = kDefaultInGameTicksBeforeNetDeath;
     //	sSpokePreferences.mOutgoingFlagsQueueSize = kDefaultOutgoingFlagsQueueSize;
-    sSpokePreferences.mRecoverySendPeriod = kDefaultRecoverySendPeriod;
-    sSpokePreferences.mTimingWindowSize   = kDefaultTimingWindowSize;
-    sSpokePreferences.mTimingNthElement   = kDefaultTimingNthElement;
-    sSpokePreferences.mAdjustTiming       = true;
+    sSpokePreferences.mRecoverySendPeriod   = kDefaultRecoverySendPeriod;
+    sSpokePreferences.mTimingWindowSize     = kDefaultTimingWindowSize;
+    sSpokePreferences.mTimingNthElement     = kDefaultTimingNthElement;
+    sSpokePreferences.mSimulatedLatency     = 0;
+    sSpokePreferences.mSimulatedLossPercent = 0;
+    sSpokePreferences.mAdjustTiming         = true;
+    sSpokePreferences.mRollback             = false;
 }
 
 #endif // !defined(DISABLE_NETWORKING)
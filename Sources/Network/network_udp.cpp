@@ -33,16 +33,30 @@
 #include "sdl_network.hpp"
 
 #include <SDL_thread.h>
+#include <atomic>
+#include <deque>
+#include <random>
+#include <vector>
 
 #include "mytm.hpp" // mytm_mutex stuff
 #include "thread_priority_sdl.hpp"
 
 // Global variables (most comments and "sSomething" variables are ZZZ)
-// Storage for incoming packet data
+// Storage for outgoing packet data
 static UDPpacket* sUDPPacketBuffer = NULL;
 
-// Storage for the DDP packet we pass back to the handler proc
-static DDPPacketBuffer ddpPacketBuffer;
+// Storage for incoming packet data; the receiving thread reads everything that's
+// pending into these, a batch at a time
+enum { kReceiveBatchSize = 32 };
+static UDPpacket** sReceivePackets = NULL;
+
+// Received packets wait here for the packet handler. There is one writer, the receiving
+// thread, and one reader at a time, whoever holds the mytm mutex, so the queue itself
+// needs no lock. sQueueHead and sQueueTail count packets read and written.
+enum { kPacketQueueSize = 256 };
+static std::vector<DDPPacketBuffer> sPacketQueue;
+static std::atomic<uint32> sQueueHead(0);
+static std::atomic<uint32> sQueueTail(0);
 
 // Keep track of our one sending/receiving socket
 static UDPsocket sSocket = NULL;
@@ -59,29 +73,99 @@ static SDL_Thread* sReceivingThread = NULL;
 // See if the receiving thread should exit
 static volatile bool sKeepListening = false;
 
+// Simulated network conditions (for testing on a LAN or a single machine): every packet
+// we receive is dropped with the given probability, or else held back for the given time.
+// Only the receiving thread touches sDelayedPackets.
+struct DelayedPacket {
+    uint32 deliveryTime;
+    DDPPacketBuffer packet;
+};
+
+static volatile int32 sSimulatedLatency     = 0; // in ms
+static volatile int32 sSimulatedLossPercent = 0;
+static std::deque<DelayedPacket> sDelayedPackets;
+static std::minstd_rand sLossGenerator;
+
+// Called by the receiving thread only; a packet that doesn't fit is dropped, as the
+// network would have
+static void enqueue_packet(const IPaddress& inAddress, const byte* inData, uint16 inSize) {
+    uint32 theTail = sQueueTail.load(std::memory_order_relaxed);
+    if (theTail - sQueueHead.load(std::memory_order_acquire) == kPacketQueueSize)
+        return;
+
+    DDPPacketBuffer& thePacket = sPacketQueue[theTail % kPacketQueueSize];
+    thePacket.protocolType     = kPROTOCOL_TYPE;
+    thePacket.sourceAddress    = inAddress;
+    thePacket.datagramSize     = inSize;
+    memcpy(thePacket.datagramData, inData, inSize);
+
+    sQueueTail.store(theTail + 1, std::memory_order_release);
+}
+
+static bool packets_are_queued() {
+    return sQueueHead.load(std::memory_order_acquire) != sQueueTail.load(std::memory_order_acquire);
+}
+
+static void receive_pending_packets() {
+    int theCount;
+    do {
+        theCount = SDLNet_UDP_RecvV(sSocket, sReceivePackets);
+        for (int i = 0; i < theCount; i++) {
+            const UDPpacket* theUDPPacket = sReceivePackets[i];
+
+            bool theLoss = sSimulatedLossPercent > 0
+                           && static_cast<int32>(sLossGenerator() % 100) < sSimulatedLossPercent;
+            if (theLoss) {
+                // dropped on the floor
+            } else if (sSimulatedLatency > 0) {
+                DelayedPacket theDelayedPacket;
+                theDelayedPacket.deliveryTime         = SDL_GetTicks() + sSimulatedLatency;
+                theDelayedPacket.packet.sourceAddress = theUDPPacket->address;
+                theDelayedPacket.packet.datagramSize  = theUDPPacket->len;
+                memcpy(theDelayedPacket.packet.datagramData, theUDPPacket->data, theUDPPacket->len);
+                sDelayedPackets.push_back(theDelayedPacket);
+            } else {
+                enqueue_packet(theUDPPacket->address, theUDPPacket->data, theUDPPacket->len);
+            }
+        }
+        // a full batch means there may be more waiting
+    } while (theCount == kReceiveBatchSize && sKeepListening);
+
+    while (!sDelayedPackets.empty()
+           && static_cast<int32>(sDelayedPackets.front().deliveryTime - SDL_GetTicks()) <= 0) {
+        const DDPPacketBuffer& thePacket = sDelayedPackets.front().packet;
+        enqueue_packet(thePacket.sourceAddress, thePacket.datagramData, thePacket.datagramSize);
+        sDelayedPackets.pop_front();
+    }
+}
+
 // ZZZ: the socket listening thread loops in this function.  It calls the registered
 // packet handler when it gets something.
 static int receive_thread_function(void*) {
     while (true) {
         // We listen with a timeout so we can shut ourselves down when needed.
-        int theResult = SDLNet_CheckSockets(sSocketSet, 1000);
+        int32 theTimeout = 1000;
+        if (!sDelayedPackets.empty()) {
+            int32 theWait = static_cast<int32>(sDelayedPackets.front().deliveryTime - SDL_GetTicks());
+            theTimeout    = std::max<int32>(0, std::min(theTimeout, theWait));
+        }
+        if (packets_are_queued()) {
+            // we couldn't hand them over last time; try again soon
+            theTimeout = std::min<int32>(theTimeout, 1);
+        }
+
+        int theResult = SDLNet_CheckSockets(sSocketSet, theTimeout);
 
         if (!sKeepListening)
             break;
 
-        if (theResult > 0 && take_mytm_mutex()) {
-            theResult = SDLNet_UDP_Recv(sSocket, sUDPPacketBuffer);
-            if (theResult > 0) {
-                ddpPacketBuffer.protocolType  = kPROTOCOL_TYPE;
-                ddpPacketBuffer.sourceAddress = sUDPPacketBuffer->address;
-                ddpPacketBuffer.datagramSize  = sUDPPacketBuffer->len;
+        if (theResult > 0 || !sDelayedPackets.empty())
+            receive_pending_packets();
 
-                // Hope the other guy is done using whatever's in there!
-                // (As I recall, all uses happen in sPacketHandler and its progeny, so we should be fine.)
-                memcpy(ddpPacketBuffer.datagramData, sUDPPacketBuffer->data, sUDPPacketBuffer->len);
-
-                sPacketHandler(&ddpPacketBuffer);
-            }
+        // Deliver right away if no other network code is running; if some is, we don't wait
+        // for it, since whoever is in a hub or spoke tick delivers them before it's done.
+        if (packets_are_queued() && try_take_mytm_mutex()) {
+            NetDDPDeliverPendingPackets();
             release_mytm_mutex();
         }
     }
@@ -120,6 +204,15 @@ OSErr NetDDPOpenSocket(short* ioPortNumber, PacketHandlerProcPtr packetHandler)
     if (sUDPPacketBuffer == NULL)
         return -1;
 
+    assert(!sReceivePackets);
+    sReceivePackets = SDLNet_AllocPacketV(kReceiveBatchSize, ddpMaxData);
+    if (sReceivePackets == NULL) {
+        SDLNet_FreePacket(sUDPPacketBuffer);
+        sUDPPacketBuffer = NULL;
+        return -1;
+    }
+    sPacketQueue.resize(kPacketQueueSize);
+
     // PORTGUESS
     // Open socket (SDLNet_Open seems to like port in host byte order)
     // NOTE: only SDLNet_UDP_Open wants port in host byte order.  All other uses of port in SDL_net
@@ -128,6 +221,8 @@ OSErr NetDDPOpenSocket(short* ioPortNumber, PacketHandlerProcPtr packetHandler)
     if (sSocket == NULL) {
         SDLNet_FreePacket(sUDPPacketBuffer);
         sUDPPacketBuffer = NULL;
+        SDLNet_FreePacketV(sReceivePackets);
+        sReceivePackets = NULL;
         return -1;
     }
 
@@ -164,6 +259,11 @@ OSErr NetDDPCloseSocket(short portNumber) {
         SDL_WaitThread(sReceivingThread, NULL);
         sReceivingThread = NULL;
     }
+    sDelayedPackets.clear();
+
+    // whatever wasn't handled is dropped
+    sPacketQueue.clear();
+    sQueueHead = sQueueTail = 0;
 
     if (sSocketSet) {
         SDLNet_FreeSocketSet(sSocketSet);
@@ -175,12 +275,40 @@ OSErr NetDDPCloseSocket(short portNumber) {
         SDLNet_FreePacket(sUDPPacketBuffer);
         sUDPPacketBuffer = NULL;
 
+        SDLNet_FreePacketV(sReceivePackets);
+        sReceivePackets = NULL;
+
         SDLNet_UDP_Close(sSocket);
         sSocket = NULL;
     }
     return 0;
 }
 
+/*
+ *  Hand received packets to the packet handler
+ */
+
+// The caller must hold the mytm mutex.
+void NetDDPDeliverPendingPackets(void) {
+    uint32 theHead = sQueueHead.load(std::memory_order_relaxed);
+    uint32 theTail = sQueueTail.load(std::memory_order_acquire);
+    while (theHead != theTail) {
+        sPacketHandler(&sPacketQueue[theHead % kPacketQueueSize]);
+
+        // only now can the receiving thread reuse the entry
+        sQueueHead.store(++theHead, std::memory_order_release);
+    }
+}
+
+/*
+ *  Simulate a slow or lossy network
+ */
+
+void NetDDPSetSimulatedConditions(int32 inLatency, int32 inLossPercent) {
+    sSimulatedLatency     = std::max<int32>(inLatency, 0);
+    sSimulatedLossPercent = std::max<int32>(inLossPercent, 0);
+}
+
 /*
  *  Allocate frame
  */
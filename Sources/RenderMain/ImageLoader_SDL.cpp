@@ -43,8 +43,6 @@ bool ImageDescriptor::LoadFromFile(FileSpecifier& File, int ImgMode, int flags,
     // Don't load opacity if there is no color component:
     switch (ImgMode) {
         case ImageLoader_Colors:
-            if (LoadDDSFromFile(File, flags, actual_width, actual_height, maxSize))
-                return true;
             break;
 
         case ImageLoader_Opacity:
@@ -56,11 +54,20 @@ bool ImageDescriptor::LoadFromFile(FileSpecifier& File, int ImgMode, int flags,
             vassert(false, csprintf(temporary, "Bad image mode for loader: %d", ImgMode));
     }
 
-    // Load image to surface
+    // Opened once, for the DDS check and the image loader both
     OpenedFile of;
     if (!File.Open(of)) {
         return false;
     }
+
+    if (ImgMode == ImageLoader_Colors) {
+        if (LoadDDSFromFile(of, flags, actual_width, actual_height, maxSize))
+            return true;
+        if (!of.SetPosition(0))
+            return false;
+    }
+
+    // Load image to surface
 #ifdef HAVE_SDL_IMAGE
     SDL_Surface* s = IMG_Load_RW(of.GetRWops(), 0);
 #else
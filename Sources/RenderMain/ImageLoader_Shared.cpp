@@ -301,13 +301,8 @@ bool ImageDescriptor::SkipMipMapFromFile(OpenedFile& File, int flags, int level,
     return false;
 }
 
-bool ImageDescriptor::LoadDDSFromFile(FileSpecifier& File, int flags, int actual_width, int actual_height,
+bool ImageDescriptor::LoadDDSFromFile(OpenedFile& dds_file, int flags, int actual_width, int actual_height,
                                       int maxSize) {
-    OpenedFile dds_file;
-    if (!File.Open(dds_file)) {
-        return false;
-    }
-
     Uint32 dwMagic;
     if (!dds_file.Read(4, &dwMagic))
         return false;
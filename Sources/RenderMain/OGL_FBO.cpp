@@ -88,6 +88,8 @@ void FBO::deactivate() {
     }
 }
 
+FBO* FBO::active_fbo() { return active_chain.size() ? active_chain.back() : NULL; }
+
 void FBO::draw() {
     glBindTexture(GL_TEXTURE_RECTANGLE_ARB, texID);
     glEnable(GL_TEXTURE_RECTANGLE_ARB);
@@ -126,6 +128,17 @@ void FBO::draw_full(bool blend) {
     reset_drawing_mode();
 }
 
+void FBO::attach_second_target(GLuint texture) {
+    glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_TEXTURE_RECTANGLE_ARB, texture, 0);
+    const GLenum buffers[] = {GL_COLOR_ATTACHMENT0_EXT, GL_COLOR_ATTACHMENT1_EXT};
+    glDrawBuffers(2, buffers);
+}
+
+void FBO::detach_second_target() {
+    glDrawBuffer(GL_COLOR_ATTACHMENT0_EXT);
+    glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_TEXTURE_RECTANGLE_ARB, 0, 0);
+}
+
 FBO::~FBO() {
     glDeleteFramebuffersEXT(1, &_fbo);
     glDeleteRenderbuffersEXT(1, &_depthBuffer);
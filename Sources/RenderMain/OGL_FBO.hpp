@@ -63,6 +63,10 @@ class FBO {
     void reset_drawing_mode();
     void draw_full(bool blend = false);
 
+    // while active, also send fragment output 1 to a texture of the same size
+    void attach_second_target(GLuint texture);
+    void detach_second_target();
+
     static FBO* active_fbo();
 };
 
@@ -0,0 +1,145 @@
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+/*
+ *  Persistent vertex buffer for world geometry
+ */
+
+#include "OGL_GeometryCache.hpp"
+
+#ifdef HAVE_OPENGL
+
+#include <stddef.h>
+#include <string.h>
+
+GeometryCache::GeometryCache() : _vbo(0), _buffer_capacity(0), _dirty_begin(0), _dirty_end(0) {}
+
+GeometryCache::~GeometryCache() {
+    if (_vbo)
+        glDeleteBuffers(1, &_vbo);
+}
+
+void GeometryCache::reset() {
+    _vertices.clear();
+    _polygon_slots.clear();
+    _side_slots.clear();
+    _free_ranges.clear();
+    _dirty_begin = _dirty_end = 0;
+}
+
+GLint GeometryCache::store_polygon_surface(size_t key, const GeometryVertex* vertices, GLsizei count) {
+    if (key >= _polygon_slots.size())
+        _polygon_slots.resize(key + 1, Slot{0, 0});
+    return store(_polygon_slots[key], vertices, count);
+}
+
+GLint GeometryCache::store_side_surface(const void* key, const GeometryVertex* vertices, GLsizei count) {
+    return store(_side_slots.emplace(key, Slot{0, 0}).first->second, vertices, count);
+}
+
+GLint GeometryCache::store(Slot& slot, const GeometryVertex* vertices, GLsizei count) {
+    if (count > slot.capacity) {
+        // new surface (or one that outgrew its range): take the smallest free range
+        // it fits, or append it
+        if (slot.capacity)
+            _free_ranges.emplace(slot.capacity, slot.first);
+
+        auto range = _free_ranges.lower_bound(count);
+        if (range != _free_ranges.end()) {
+            slot.first    = range->second;
+            slot.capacity = range->first;
+            _free_ranges.erase(range);
+        } else {
+            slot.first    = static_cast<GLint>(_vertices.size());
+            slot.capacity = count;
+            _vertices.resize(_vertices.size() + count);
+        }
+    } else if (memcmp(&_vertices[slot.first], vertices, count * sizeof(GeometryVertex)) == 0) {
+        return slot.first;
+    }
+
+    memcpy(&_vertices[slot.first], vertices, count * sizeof(GeometryVertex));
+
+    size_t begin = slot.first;
+    size_t end   = begin + count;
+    if (_dirty_begin == _dirty_end) {
+        _dirty_begin = begin;
+        _dirty_end   = end;
+    } else {
+        _dirty_begin = std::min(_dirty_begin, begin);
+        _dirty_end   = std::max(_dirty_end, end);
+    }
+
+    return slot.first;
+}
+
+void GeometryCache::upload() {
+    if (_vertices.size() > _buffer_capacity) {
+        // grow geometrically, so a level's first frames don't reallocate over and over
+        _buffer_capacity = std::max(_vertices.size(), 2 * _buffer_capacity);
+        glBufferData(GL_ARRAY_BUFFER, _buffer_capacity * sizeof(GeometryVertex), NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, _vertices.size() * sizeof(GeometryVertex), _vertices.data());
+    } else if (_dirty_begin != _dirty_end) {
+        glBufferSubData(GL_ARRAY_BUFFER, _dirty_begin * sizeof(GeometryVertex),
+                        (_dirty_end - _dirty_begin) * sizeof(GeometryVertex), &_vertices[_dirty_begin]);
+    }
+    _dirty_begin = _dirty_end = 0;
+}
+
+void GeometryCache::bind(bool colors) {
+    if (!_vbo)
+        glGenBuffers(1, &_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    upload();
+
+    const GLsizei stride = sizeof(GeometryVertex);
+    glVertexPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(GeometryVertex, position)));
+    glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(GeometryVertex, texcoord)));
+
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(GeometryVertex, normal)));
+
+    if (colors) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(GeometryVertex, color)));
+    }
+
+    glClientActiveTextureARB(GL_TEXTURE1_ARB);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(4, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(GeometryVertex, tangent)));
+    glClientActiveTextureARB(GL_TEXTURE0_ARB);
+}
+
+void GeometryCache::unbind() {
+    glClientActiveTextureARB(GL_TEXTURE1_ARB);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glClientActiveTextureARB(GL_TEXTURE0_ARB);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+
+    // everything else still draws from client memory
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _OGL_GEOMETRY_CACHE_
+#define _OGL_GEOMETRY_CACHE_
+
+/*
+ *
+ *  Aleph Bet is copyright ©1994-2024 Bungie Inc., the Aleph One developers,
+ *  and the Aleph Bet developers.
+ *
+ *  Aleph Bet is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Aleph Bet is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *  This license notice applies only to the Aleph Bet engine itself, and
+ *  does not apply to Marathon, Marathon 2, or Marathon Infinity scenarios
+ *  and assets, nor to elements of any third-party scenarios.
+ *
+ */
+
+/*
+ *  Persistent vertex buffer for world geometry
+ *
+ *  Every floor, ceiling, liquid surface and wall part gets its own range in
+ *  one buffer object the first time it is drawn. Surfaces are stored as
+ *  triangle lists, and a range is only re-uploaded when its contents change
+ *  (platforms moving, liquids rising, sliding textures). A surface that outgrows
+ *  its range moves to a larger one, and the range it leaves is handed to the
+ *  next surface it fits.
+ */
+
+#include "cseries.hpp"
+
+#ifdef HAVE_OPENGL
+
+#include "OGL_Headers.hpp"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+struct GeometryVertex {
+    GLfloat position[3];
+    GLfloat texcoord[2];
+    GLfloat normal[3];
+    GLfloat tangent[4]; // w is the bitangent sign
+    GLfloat color[3];   // light intensity
+};
+
+class GeometryCache {
+
+  private:
+
+    struct Slot {
+        GLint first;
+        GLsizei capacity;
+    };
+
+    GLuint _vbo;
+    size_t _buffer_capacity; // in vertices
+
+    // what the buffer object contains (or will, after the next upload)
+    std::vector<GeometryVertex> _vertices;
+    size_t _dirty_begin;
+    size_t _dirty_end;
+
+    std::vector<Slot> _polygon_slots;
+    std::unordered_map<const void*, Slot> _side_slots;
+
+    // ranges left behind by surfaces that outgrew them, by capacity
+    std::multimap<GLsizei, GLint> _free_ranges;
+
+    GLint store(Slot& slot, const GeometryVertex* vertices, GLsizei count);
+    void upload();
+
+  public:
+
+    GeometryCache();
+    ~GeometryCache();
+
+    // Forgets every surface; call this when a new map is loaded
+    void reset();
+
+    // Store a surface, returning the index of its first vertex in the buffer;
+    // polygon surfaces are keyed by an index, wall parts by their texture definition
+    GLint store_polygon_surface(size_t key, const GeometryVertex* vertices, GLsizei count);
+    GLint store_side_surface(const void* key, const GeometryVertex* vertices, GLsizei count);
+
+    // Upload pending changes and point the vertex arrays at the buffer; without
+    // colors, surfaces are drawn in the current color instead of their light's
+    void bind(bool colors);
+    void unbind();
+};
+
+#endif // def HAVE_OPENGL
+
+#endif
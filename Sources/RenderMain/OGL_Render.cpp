@@ -448,6 +448,18 @@ bool OGL_StartRun() {
             Bloom_sRGB = true;
     }
 
+    Bloom_MRT = false;
+    if (TEST_FLAG(graphics_preferences->OGL_Configure.Flags, OGL_Flag_Blur)) {
+        GLint draw_buffers      = 0;
+        GLint color_attachments = 0;
+        glGetIntegerv(GL_MAX_DRAW_BUFFERS, &draw_buffers);
+        glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS_EXT, &color_attachments);
+        if (draw_buffers < 2 || color_attachments < 2) {
+            logNote("Multiple render targets not available; bloom effects need a second pass");
+        } else
+            Bloom_MRT = true;
+    }
+
     _OGL_IsActive = true;
     OGL_StartProgress(count_replacement_collections() + 2);
 
@@ -52,6 +52,7 @@ static bool _OGL_IsPresent = false;
 bool Using_sRGB   = false;
 bool Wanting_sRGB = false;
 bool Bloom_sRGB   = false;
+bool Bloom_MRT    = false;
 bool FBO_Allowed  = false;
 bool npotTextures = false; // non-power-of-two
 
@@ -322,6 +323,23 @@ void OGL_TextureOptionsBase::Load() {
     }
 }
 
+void OGL_TextureOptionsBase::GetFiles(std::vector<FileSpecifier>& Files) {
+    if (NormalImg.IsPresent() || NormalColors == FileSpecifier())
+        return;
+
+    Files.push_back(NormalColors);
+    if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap) && OffsetMap != FileSpecifier())
+        Files.push_back(OffsetMap);
+    if (NormalMask != FileSpecifier())
+        Files.push_back(NormalMask);
+
+    if (!GlowImg.IsPresent() && GlowColors != FileSpecifier()) {
+        Files.push_back(GlowColors);
+        if (GlowMask != FileSpecifier())
+            Files.push_back(GlowMask);
+    }
+}
+
 void OGL_TextureOptionsBase::Unload() {
     NormalImg.Clear();
     GlowImg.Clear();
@@ -357,6 +375,13 @@ void OGL_LoadModelsImages(short Collection) {
         OGL_UnloadModels(Collection);
 }
 
+// Models aren't listed; they're few, and their loaders read them piecemeal
+void OGL_GetModelsImagesFiles(short Collection, std::vector<FileSpecifier>& Files) {
+    assert(Collection >= 0 && Collection < MAXIMUM_COLLECTIONS);
+
+    OGL_GetTextureFiles(Collection, Files);
+}
+
 void OGL_UnloadModelsImages(short Collection) {
     assert(Collection >= 0 && Collection < MAXIMUM_COLLECTIONS);
 
@@ -373,6 +398,8 @@ void OGL_LoadModelsImages(short) {}
 
 void OGL_UnloadModelsImages(short) {}
 
+void OGL_GetModelsImagesFiles(short, std::vector<FileSpecifier>&) {}
+
 #endif // def HAVE_OPENGL
 
 
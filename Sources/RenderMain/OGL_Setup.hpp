@@ -79,6 +79,8 @@ extern bool Using_sRGB;
 extern bool Wanting_sRGB;
 /* Whether to use sRGB framebuffer for bloom */
 extern bool Bloom_sRGB;
+/* Whether bloom can be drawn in the same pass as the scene, to a second color attachment */
+extern bool Bloom_MRT;
 /* Whether we can use framebuffer objects */
 extern bool FBO_Allowed;
 
@@ -234,6 +236,7 @@ void OGL_SetDefaults(OGL_ConfigureData& Data);
 int OGL_CountModelsImages(short Collection);
 void OGL_LoadModelsImages(short Collection);
 void OGL_UnloadModelsImages(short Collection);
+void OGL_GetModelsImagesFiles(short Collection, std::vector<FileSpecifier>& Files);
 
 // Reset the textures (walls, sprites, and model skins) (good if they start to crap out)
 // Implemented in OGL_Textures.cpp
@@ -28,6 +28,8 @@
 
 #include <algorithm>
 #include <iostream>
+#include <regex>
+#include <set>
 
 #include "FileHandler.hpp"
 #include "InfoTree.hpp"
@@ -108,7 +110,24 @@ const char* Shader::_shader_names[NUMBER_OF_SHADER_TYPES] = {"error",
                                                              "gamma",
                                                              "landscape_sphere",
                                                              "landscape_sphere_bloom",
-                                                             "landscape_sphere_infravision"};
+                                                             "landscape_sphere_infravision",
+                                                             "landscape_mrt",
+                                                             "landscape_sphere_mrt",
+                                                             "sprite_mrt",
+                                                             "invincible_mrt",
+                                                             "invisible_mrt",
+                                                             "wall_mrt",
+                                                             "bump_mrt"};
+
+// combined shader, diffuse source, bloom source
+static const Shader::ShaderType mrt_sources[][3] = {
+        {Shader::S_LandscapeMRT, Shader::S_Landscape, Shader::S_LandscapeBloom},
+        {Shader::S_LandscapeSphereMRT, Shader::S_LandscapeSphere, Shader::S_LandscapeSphereBloom},
+        {Shader::S_SpriteMRT, Shader::S_Sprite, Shader::S_SpriteBloom},
+        {Shader::S_InvincibleMRT, Shader::S_Invincible, Shader::S_InvincibleBloom},
+        {Shader::S_InvisibleMRT, Shader::S_Invisible, Shader::S_InvisibleBloom},
+        {Shader::S_WallMRT, Shader::S_Wall, Shader::S_WallBloom},
+        {Shader::S_BumpMRT, Shader::S_Bump, Shader::S_BumpBloom}};
 
 class Shader_MML_Parser {
   public:
@@ -136,6 +155,7 @@ void Shader_MML_Parser::parse(const InfoTree& root) {
             root.read_attr("passes", passes);
 
             Shader::_shaders[i] = Shader(name, vert, frag, passes);
+            Shader::setupMRT();
             break;
         }
     }
@@ -166,6 +186,48 @@ void parseFile(FileSpecifier& fileSpec, std::string& s) {
     file.Read(length, &s[0]);
 }
 
+// Turn a fragment shader into one half of a multiple-render-target program:
+// main() becomes <prefix>_main() and writes <prefix>_color instead of
+// gl_FragColor. Both halves are linked into one program, so with
+// rename_globals the functions and constants get the prefix as well,
+// in case the other half defines the same names
+static std::string splitFragmentShader(const std::string& source, const std::string& prefix, bool rename_globals) {
+    std::set<std::string> names{"main", "gl_FragColor"};
+    if (rename_globals) {
+        static const std::regex function_definition(
+                "\\b(?:void|float|int|bool|[bi]?vec[234]|mat[234])\\s+([A-Za-z_]\\w*)\\s*\\(");
+        static const std::regex constant_definition("\\bconst\\s+\\w+\\s+([A-Za-z_]\\w*)");
+        for (auto* re : {&function_definition, &constant_definition}) {
+            for (std::sregex_iterator it(source.begin(), source.end(), *re), end; it != end; ++it) {
+                names.insert((*it)[1]);
+            }
+        }
+    }
+
+    std::string result = source;
+    for (auto& name : names) {
+        std::string replacement = prefix + "_" + name;
+        if (name == "main")
+            replacement = prefix + "_main";
+        else if (name == "gl_FragColor")
+            replacement = prefix + "_color";
+        result = std::regex_replace(result, std::regex("\\b" + name + "\\b"), replacement);
+    }
+    return "vec4 " + prefix + "_color;\n" + result;
+}
+
+static const char* mrtMainShader = ""
+                                   "vec4 diffuse_color;\n"
+                                   "vec4 glow_color;\n"
+                                   "void diffuse_main();\n"
+                                   "void glow_main();\n"
+                                   "void main(void) {\n"
+                                   "	diffuse_main();\n"
+                                   "	glow_main();\n"
+                                   "	gl_FragData[0] = diffuse_color;\n"
+                                   "	gl_FragData[1] = glow_color;\n"
+                                   "}\n";
+
 GLhandleARB parseShader(const GLcharARB* str, GLenum shaderType) {
 
     GLint status;
@@ -212,6 +274,18 @@ void Shader::loadAll() {
     if (!_shaders.size()) {
         _shaders.reserve(NUMBER_OF_SHADER_TYPES);
         for (int i = 0; i < NUMBER_OF_SHADER_TYPES; ++i) { _shaders.push_back(Shader(_shader_names[i])); }
+        setupMRT();
+    }
+}
+
+void Shader::setupMRT() {
+    for (auto& sources : mrt_sources) {
+        Shader& s    = _shaders[sources[0]];
+        s._vert      = _shaders[sources[1]]._vert;
+        s._frag      = _shaders[sources[1]]._frag;
+        s._glow_frag = _shaders[sources[2]]._frag;
+        s._passes    = _shaders[sources[1]]._passes;
+        s.unload();
     }
 }
 
@@ -264,19 +338,36 @@ void Shader::init() {
     glDeleteObjectARB(vertexShader);
 
     assert(!_frag.empty());
-    GLhandleARB fragmentShader = parseShader(_frag.c_str(), GL_FRAGMENT_SHADER_ARB);
-    if (!fragmentShader) {
-        _frag          = defaultFragmentPrograms["error"];
-        fragmentShader = parseShader(_frag.c_str(), GL_FRAGMENT_SHADER_ARB);
-    }
+    if (!_glow_frag.empty()) {
+        std::string diffuse = splitFragmentShader(_frag, "diffuse", false);
+        std::string glow    = splitFragmentShader(_glow_frag, "glow", true);
+        for (const char* str : {diffuse.c_str(), glow.c_str(), mrtMainShader}) {
+            GLhandleARB fragmentShader = parseShader(str, GL_FRAGMENT_SHADER_ARB);
+            if (fragmentShader) {
+                glAttachObjectARB(_programObj, fragmentShader);
+                glDeleteObjectARB(fragmentShader);
+            }
+        }
+    } else {
+        GLhandleARB fragmentShader = parseShader(_frag.c_str(), GL_FRAGMENT_SHADER_ARB);
+        if (!fragmentShader) {
+            _frag          = defaultFragmentPrograms["error"];
+            fragmentShader = parseShader(_frag.c_str(), GL_FRAGMENT_SHADER_ARB);
+        }
 
-    glAttachObjectARB(_programObj, fragmentShader);
-    glDeleteObjectARB(fragmentShader);
+        glAttachObjectARB(_programObj, fragmentShader);
+        glDeleteObjectARB(fragmentShader);
+    }
 
     glLinkProgramARB(_programObj);
 
     GLint linked;
     glGetProgramiv((GLuint)(size_t)_programObj, GL_LINK_STATUS, &linked);
+    if (!linked && !_glow_frag.empty()) {
+        // fall back to drawing bloom in a second pass
+        logWarning("Could not link single-pass bloom shader; disabling it");
+        Bloom_MRT = false;
+    }
     if (!linked) {
         GLint infoLen = 0;
         glGetProgramiv((GLuint)(size_t)_programObj, GL_INFO_LOG_LENGTH, &infoLen);
@@ -102,6 +102,14 @@ class Shader {
         S_LandscapeSphere,
         S_LandscapeSphereBloom,
         S_LandscapeSphereInfravision,
+        // diffuse and bloom shaders linked together, for single-pass bloom
+        S_LandscapeMRT,
+        S_LandscapeSphereMRT,
+        S_SpriteMRT,
+        S_InvincibleMRT,
+        S_InvisibleMRT,
+        S_WallMRT,
+        S_BumpMRT,
         NUMBER_OF_SHADER_TYPES
     };
 
@@ -110,12 +118,15 @@ class Shader {
     GLhandleARB _programObj;
     std::string _vert;
     std::string _frag;
+    std::string _glow_frag; // if set, written to the second color attachment
     int16 _passes;
     bool _loaded;
 
     static const char* _shader_names[NUMBER_OF_SHADER_TYPES];
     static std::vector<Shader> _shaders;
 
+    static void setupMRT();
+
     static const char* _uniform_names[NUMBER_OF_UNIFORM_LOCATIONS];
     GLint _uniform_locations[NUMBER_OF_UNIFORM_LOCATIONS];
     float _cached_floats[NUMBER_OF_UNIFORM_LOCATIONS];
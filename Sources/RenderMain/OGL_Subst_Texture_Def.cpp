@@ -31,6 +31,7 @@
 #include "InfoTree.hpp"
 #include "Logging.hpp"
 #include "PairOfShortsHash.hpp"
+#include "WorkerPool.hpp"
 #include "cseries.hpp"
 
 #include <set>
@@ -58,11 +59,31 @@ int OGL_CountTextures(short Collection) { return Collections[Collection].size();
 
 extern void OGL_ProgressCallback(int);
 
+static WorkerPool* texture_workers = NULL;
+
+// Each texture decodes into images of its own, without touching OpenGL, so they're
+// decoded several at once and come out the same as one at a time; the progress bar
+// is drawn between batches, on this thread
 void OGL_LoadTextures(short Collection) {
+    if (!texture_workers)
+        texture_workers = new WorkerPool(WorkerPool::default_thread_count());
+
+    std::vector<OGL_TextureOptions*> textures;
+    for (TOHash::iterator it = Collections[Collection].begin(); it != Collections[Collection].end(); ++it) {
+        textures.push_back(&it->second);
+    }
+
+    const size_t batch_size = 4 * texture_workers->concurrency();
+    for (size_t first = 0; first < textures.size(); first += batch_size) {
+        int count = static_cast<int>(MIN(batch_size, textures.size() - first));
+        texture_workers->run(count, [&](int i) { textures[first + i]->Load(); });
+        OGL_ProgressCallback(count);
+    }
+}
 
+void OGL_GetTextureFiles(short Collection, std::vector<FileSpecifier>& Files) {
     for (TOHash::iterator it = Collections[Collection].begin(); it != Collections[Collection].end(); ++it) {
-        it->second.Load();
-        OGL_ProgressCallback(1);
+        it->second.GetFiles(Files);
     }
 }
 
@@ -52,6 +52,7 @@ OGL_TextureOptions* OGL_GetTextureOptions(short Collection, short CLUT, short Bi
 // for managing the texture loading and unloading;
 int OGL_CountTextures(short Collection);
 void OGL_LoadTextures(short Collection);
+void OGL_GetTextureFiles(short Collection, std::vector<FileSpecifier>& Files);
 void OGL_UnloadTextures(short Collection);
 
 class InfoTree;
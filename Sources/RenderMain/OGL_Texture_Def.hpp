@@ -140,6 +140,9 @@ struct OGL_TextureOptionsBase {
     void Load();
     void Unload();
 
+    // Adds the files Load() would read, in the order it reads them
+    void GetFiles(std::vector<FileSpecifier>& Files);
+
     virtual int GetMaxSize();
 
     OGL_TextureOptionsBase()
@@ -118,6 +118,12 @@ void Rasterizer_Shader_Class::SetView(view_data& view) {
     s->enable();
     s->setMatrix4(Shader::U_LandscapeInverseMatrix, landscapeInverseMatrix);
 
+    if (Bloom_MRT) {
+        s = Shader::get(Shader::S_LandscapeMRT);
+        s->enable();
+        s->setMatrix4(Shader::U_LandscapeInverseMatrix, landscapeInverseMatrix);
+    }
+
     Shader::disable();
 
     // setup the normal view matrix
@@ -74,7 +74,8 @@ struct vertical_surface_data {
 
 typedef enum {
     kDiffuse,
-    kGlow
+    kGlow,
+    kDiffuseAndGlow // both at once, into two color attachments
 } RenderStep;
 
 class RenderRasterizerClass {
@@ -31,6 +31,7 @@
 #include "AnimatedTextures.hpp"
 #include "ChaseCam.hpp"
 #include "OGL_Faders.hpp"
+#include "OGL_GeometryCache.hpp"
 #include "OGL_Shader.hpp"
 #include "OGL_Textures.hpp"
 #include "lightsource.hpp"
@@ -42,13 +43,12 @@
 
 #ifdef HAVE_OPENGL
 
-#define MAXIMUM_VERTICES_PER_WORLD_POLYGON (MAXIMUM_VERTICES_PER_POLYGON + 4)
-
 class Blur {
 
   private:
 
     FBOSwapper _swapper;
+    std::unique_ptr<FBO> _glow; // full size, for single-pass rendering
     Shader* _shader_blur;
     Shader* _shader_bloom;
     GLuint _width;
@@ -70,6 +70,24 @@ class Blur {
 
     void end() { _swapper.swap(); }
 
+    // render the glow into a second color attachment of the scene's FBO
+    void begin_single_pass(FBO& target) {
+        if (!_glow.get() || _glow->_w != target._w || _glow->_h != target._h) {
+            _glow.reset(new FBO(target._w, target._h, target._srgb));
+        }
+        _glow->activate(true);
+        _glow->deactivate();
+        target.attach_second_target(_glow->texID);
+    }
+
+    // then scale it down to the size begin() would have drawn it at
+    void end_single_pass(FBO& target) {
+        target.detach_second_target();
+        begin();
+        _glow->draw_full();
+        end();
+    }
+
     void draw(FBOSwapper& dest) {
 
         int passes = _shader_bloom->passes();
@@ -103,7 +121,50 @@ class Blur {
     }
 };
 
-RenderRasterize_Shader::RenderRasterize_Shader()  = default;
+// Walls, floors and ceilings waiting to be drawn, collected by everything that needs
+// its own draw call: texture, transfer mode, shader setup and clipping. Light intensity
+// is a vertex color, so surfaces lit differently still share a bucket.
+struct SurfaceBucket {
+    clipping_window_data* window;
+    shape_descriptor texture;
+    short transfer_mode;
+    float pulsate;
+    float wobble;
+    float glow_wobble;
+    float offset;
+    bool void_present;
+    bool horizontal;
+
+    // filled in when the bucket is opened
+    float tile_ratio;
+    bool blended;
+
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+};
+
+// Opaque buckets can be drawn in any order, since the depth test sorts them out; blended
+// ones are drawn after them, in the order their surfaces came in
+struct SurfaceBatch {
+    std::vector<SurfaceBucket> buckets; // those past used keep their storage for the next frame
+    size_t used         = 0;
+    size_t last_blended = 0; // the only blended bucket more surfaces may join, if any
+    bool any_blended    = false;
+};
+
+Shader* stepShader(RenderStep renderStep, Shader::ShaderType diffuse, Shader::ShaderType glow,
+                   Shader::ShaderType combined) {
+    switch (renderStep) {
+        case kGlow:
+            return Shader::get(glow);
+        case kDiffuseAndGlow:
+            return Shader::get(combined);
+        default:
+            return Shader::get(diffuse);
+    }
+}
+
+RenderRasterize_Shader::RenderRasterize_Shader() : batch(std::make_unique<SurfaceBatch>()) {}
 RenderRasterize_Shader::~RenderRasterize_Shader() = default;
 
 /*
@@ -128,10 +189,28 @@ void RenderRasterize_Shader::setupGL(Rasterizer_Shader_Class& Rasterizer) {
         }
     }
 
+    // link the single-pass bloom shaders now, so that a failure
+    // falls back to two passes before the first frame is drawn
+    if (blur.get() && Bloom_MRT) {
+        for (auto type : {Shader::S_LandscapeMRT, Shader::S_LandscapeSphereMRT, Shader::S_SpriteMRT,
+                          Shader::S_InvincibleMRT, Shader::S_InvisibleMRT, Shader::S_WallMRT, Shader::S_BumpMRT}) {
+            Shader::get(type)->enable();
+        }
+        Shader::disable();
+    }
+
+    geometry.reset(new GeometryCache());
+
     //	glDisable(GL_CULL_FACE);
     //	glDisable(GL_LIGHTING);
 }
 
+void RenderRasterize_Shader::reset_geometry() {
+    if (geometry.get()) {
+        geometry->reset();
+    }
+}
+
 /*
  * override for RenderRasterizerClass::render_tree()
  *
@@ -146,6 +225,11 @@ void RenderRasterize_Shader::render_tree() {
     weaponFlare    = PIN(view->maximum_depth_intensity - NATURAL_LIGHT_INTENSITY, 0, FIXED_ONE) / float(FIXED_ONE);
     selfLuminosity = PIN(NATURAL_LIGHT_INTENSITY, 0, FIXED_ONE) / float(FIXED_ONE);
 
+    bool glow = current_player->infravision_duration == 0 && TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_Blur)
+                && blur.get();
+    // draw the glow in the same pass as the scene, if the shaders allow it
+    bool single_pass = glow && Bloom_MRT;
+
     Shader* s = Shader::get(Shader::S_Invincible);
     s->enable();
     s->setFloat(Shader::U_Time, view->tick_count);
@@ -153,7 +237,15 @@ void RenderRasterize_Shader::render_tree() {
     s->setFloat(Shader::U_LogicalHeight, view->screen_height);
     s->setFloat(Shader::U_PixelWidth, view->screen_width * MainScreenPixelScale());
     s->setFloat(Shader::U_PixelHeight, view->screen_height * MainScreenPixelScale());
-    if (blur.get()) {
+    if (single_pass) {
+        s = Shader::get(Shader::S_InvincibleMRT);
+        s->enable();
+        s->setFloat(Shader::U_Time, view->tick_count);
+        s->setFloat(Shader::U_LogicalWidth, view->screen_width);
+        s->setFloat(Shader::U_LogicalHeight, view->screen_height);
+        s->setFloat(Shader::U_PixelWidth, view->screen_width * MainScreenPixelScale());
+        s->setFloat(Shader::U_PixelHeight, view->screen_height * MainScreenPixelScale());
+    } else if (blur.get()) {
         s = Shader::get(Shader::S_InvincibleBloom);
         s->enable();
         s->setFloat(Shader::U_Time, view->tick_count);
@@ -223,15 +315,48 @@ void RenderRasterize_Shader::render_tree() {
         s->setFloat(Shader::U_FogMode, fogmode);
     }
 
+    // the combined shaders are only compiled when they're used
+    if (single_pass) {
+        for (auto type : {Shader::S_LandscapeMRT, Shader::S_LandscapeSphereMRT}) {
+            s = Shader::get(type);
+            s->enable();
+            s->setFloat(Shader::U_FogMix, fogMix);
+            s->setFloat(Shader::U_Yaw, virtual_yaw);
+            s->setFloat(Shader::U_Pitch, view->mimic_sw_perspective ? 0.0 : virtual_pitch);
+        }
+        for (auto type : {Shader::S_BumpMRT, Shader::S_InvincibleMRT, Shader::S_InvisibleMRT, Shader::S_WallMRT,
+                          Shader::S_SpriteMRT}) {
+            s = Shader::get(type);
+            s->enable();
+            s->setFloat(Shader::U_FogMode, fogmode);
+        }
+    }
+
     Shader::disable();
 
+    if (single_pass) {
+        FBO* target = FBO::active_fbo();
+        blur->begin_single_pass(*target);
+        RenderRasterizerClass::render_tree(kDiffuseAndGlow);
+        flush_batch(kDiffuseAndGlow);
+        render_viewer_sprite_layer(kDiffuseAndGlow);
+        blur->end_single_pass(*target);
+        RasPtr->swapper->deactivate();
+        blur->draw(*RasPtr->swapper);
+        RasPtr->swapper->activate();
+
+        glAlphaFunc(GL_GREATER, 0.5);
+        return;
+    }
+
     RenderRasterizerClass::render_tree(kDiffuse);
+    flush_batch(kDiffuse);
     render_viewer_sprite_layer(kDiffuse);
 
-    if (current_player->infravision_duration == 0 && TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_Blur)
-        && blur.get()) {
+    if (glow) {
         blur->begin();
         RenderRasterizerClass::render_tree(kGlow);
+        flush_batch(kGlow);
         render_viewer_sprite_layer(kGlow);
         blur->end();
         RasPtr->swapper->deactivate();
@@ -285,6 +410,21 @@ void RenderRasterize_Shader::clip_to_window(clipping_window_data* win) {
     glPopMatrix();
 }
 
+// whether clip_to_window() would set up the same planes for both windows
+bool RenderRasterize_Shader::same_clipping(const clipping_window_data* a, const clipping_window_data* b) const {
+    if (a == b) {
+        return true;
+    }
+    bool left_a  = a->left.i != leftmost_clip.i || a->left.j != leftmost_clip.j;
+    bool left_b  = b->left.i != leftmost_clip.i || b->left.j != leftmost_clip.j;
+    bool right_a = a->right.i != rightmost_clip.i || a->right.j != rightmost_clip.j;
+    bool right_b = b->right.i != rightmost_clip.i || b->right.j != rightmost_clip.j;
+    if (left_a != left_b || right_a != right_b) {
+        return false;
+    }
+    return (!left_a || a->left == b->left) && (!right_a || a->right == b->right);
+}
+
 void RenderRasterize_Shader::store_endpoint(endpoint_data* endpoint, long_vector2d& p) {
     p.i = endpoint->vertex.x;
     p.j = endpoint->vertex.y;
@@ -317,6 +457,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
     }
 
     float flare = weaponFlare;
+    bool unlit  = false;
 
     glEnable(GL_TEXTURE_2D);
 
@@ -324,11 +465,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
     if (TMgr->TransferMode == _static_transfer) {
         TMgr->IsShadeless = 1;
         flare             = -1;
-        if (renderStep == kDiffuse) {
-            s = Shader::get(Shader::S_Invincible);
-        } else {
-            s = Shader::get(Shader::S_InvincibleBloom);
-        }
+        s = stepShader(renderStep, Shader::S_Invincible, Shader::S_InvincibleBloom, Shader::S_InvincibleMRT);
         s->enable();
         s->setFloat(Shader::U_TransferFadeOut, ((float)((uint16)rect.transfer_data)) / (float)((int)FIXED_ONE));
     } else if (current_player->infravision_duration) {
@@ -338,11 +475,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
         s->enable();
     } else if (TMgr->TransferMode == _tinted_transfer) {
         flare = -1;
-        if (renderStep == kDiffuse) {
-            s = Shader::get(Shader::S_Invisible);
-        } else {
-            s = Shader::get(Shader::S_InvisibleBloom);
-        }
+        s = stepShader(renderStep, Shader::S_Invisible, Shader::S_InvisibleBloom, Shader::S_InvisibleMRT);
         s->enable();
         s->setFloat(Shader::U_Visibility, 1.0 - rect.transfer_data / 32.0f);
     } else if (TMgr->TransferMode == _solid_transfer) {
@@ -352,12 +485,13 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
         color[2] = 0;
     } else if (TMgr->TransferMode == _textured_transfer) {
         if (TMgr->IsShadeless) {
-            if (renderStep == kDiffuse) {
+            if (renderStep != kGlow) {
                 color[0] = color[1] = color[2] = 1;
             } else {
                 color[0] = color[1] = color[2] = 0;
             }
             flare = -1;
+            unlit = true;
         }
     } else {
         // I've never seen this happen
@@ -367,11 +501,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
     }
 
     if (s == NULL) {
-        if (renderStep == kDiffuse) {
-            s = Shader::get(Shader::S_Sprite);
-        } else {
-            s = Shader::get(Shader::S_SpriteBloom);
-        }
+        s = stepShader(renderStep, Shader::S_Sprite, Shader::S_SpriteBloom, Shader::S_SpriteMRT);
         s->enable();
     }
 
@@ -384,8 +514,10 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupSpriteTexture(const
 
     TMgr->SetupTextureMatrix();
 
-    if (renderStep == kGlow) {
-        s->setFloat(Shader::U_BloomScale, TMgr->BloomScale());
+    if (renderStep != kDiffuse) {
+        // a separate glow pass draws shadeless sprites black; with the
+        // diffuse color, the same result comes from ignoring it
+        s->setFloat(Shader::U_BloomScale, unlit && renderStep == kDiffuseAndGlow ? 0 : TMgr->BloomScale());
         s->setFloat(Shader::U_BloomShift, TMgr->BloomShift());
     }
     s->setFloat(Shader::U_Flare, flare);
@@ -433,7 +565,8 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupWallTexture(const s
             TMgr->TransferMode = _static_transfer;
             TMgr->IsShadeless  = 1;
             flare              = -1;
-            s                  = Shader::get(renderStep == kGlow ? Shader::S_InvincibleBloom : Shader::S_Invincible);
+            s                  = stepShader(renderStep, Shader::S_Invincible, Shader::S_InvincibleBloom,
+                                            Shader::S_InvincibleMRT);
             s->enable();
             s->setFloat(Shader::U_TransferFadeOut, 0);
             break;
@@ -455,17 +588,10 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupWallTexture(const s
                 }
             } else {
                 if (opts->SphereMap) {
-                    if (renderStep == kDiffuse) {
-                        s = Shader::get(Shader::S_LandscapeSphere);
-                    } else {
-                        s = Shader::get(Shader::S_LandscapeSphereBloom);
-                    }
+                    s = stepShader(renderStep, Shader::S_LandscapeSphere, Shader::S_LandscapeSphereBloom,
+                                   Shader::S_LandscapeSphereMRT);
                 } else {
-                    if (renderStep == kDiffuse) {
-                        s = Shader::get(Shader::S_Landscape);
-                    } else {
-                        s = Shader::get(Shader::S_LandscapeBloom);
-                    }
+                    s = stepShader(renderStep, Shader::S_Landscape, Shader::S_LandscapeBloom, Shader::S_LandscapeMRT);
                 }
             }
             s->enable();
@@ -473,7 +599,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupWallTexture(const s
         default:
             TMgr->TextureType = OGL_Txtr_Wall;
             if (TMgr->IsShadeless) {
-                if (renderStep == kDiffuse) {
+                if (renderStep != kGlow) {
                     glColor4f(1, 1, 1, 1);
                 } else {
                     glColor4f(0, 0, 0, 1);
@@ -489,9 +615,9 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupWallTexture(const s
             glColor4f(color[0], color[1], color[2], 1);
             s = Shader::get(Shader::S_WallInfravision);
         } else if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap)) {
-            s = Shader::get(renderStep == kGlow ? Shader::S_BumpBloom : Shader::S_Bump);
+            s = stepShader(renderStep, Shader::S_Bump, Shader::S_BumpBloom, Shader::S_BumpMRT);
         } else {
-            s = Shader::get(renderStep == kGlow ? Shader::S_WallBloom : Shader::S_Wall);
+            s = stepShader(renderStep, Shader::S_Wall, Shader::S_WallBloom, Shader::S_WallMRT);
         }
         s->enable();
     }
@@ -527,7 +653,7 @@ std::unique_ptr<TextureManager> RenderRasterize_Shader::setupWallTexture(const s
         }
     }
 
-    if (renderStep == kGlow) {
+    if (renderStep != kDiffuse) {
         if (TMgr->TextureType == OGL_Txtr_Landscape) {
             s->setFloat(Shader::U_BloomScale, TMgr->LandscapeBloom());
         } else {
@@ -646,12 +772,12 @@ bool setupGlow(struct view_data* view, std::unique_ptr<TextureManager>& TMgr, fl
         Shader* s = NULL;
         if (TMgr->TextureType == OGL_Txtr_Wall) {
             if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap)) {
-                s = Shader::get(renderStep == kGlow ? Shader::S_BumpBloom : Shader::S_Bump);
+                s = stepShader(renderStep, Shader::S_Bump, Shader::S_BumpBloom, Shader::S_BumpMRT);
             } else {
-                s = Shader::get(renderStep == kGlow ? Shader::S_WallBloom : Shader::S_Wall);
+                s = stepShader(renderStep, Shader::S_Wall, Shader::S_WallBloom, Shader::S_WallMRT);
             }
         } else {
-            s = Shader::get(renderStep == kGlow ? Shader::S_SpriteBloom : Shader::S_Sprite);
+            s = stepShader(renderStep, Shader::S_Sprite, Shader::S_SpriteBloom, Shader::S_SpriteMRT);
         }
 
         TMgr->RenderGlowing();
@@ -662,8 +788,12 @@ bool setupGlow(struct view_data* view, std::unique_ptr<TextureManager>& TMgr, fl
         glAlphaFunc(GL_GREATER, 0.001);
 
         s->enable();
-        if (renderStep == kGlow) {
-            s->setFloat(Shader::U_BloomScale, TMgr->GlowBloomScale());
+        if (renderStep != kDiffuse) {
+            float bloomScale = TMgr->GlowBloomScale();
+            if (renderStep == kDiffuseAndGlow && TMgr->IsShadeless) {
+                bloomScale *= TMgr->MinGlowIntensity(); // as if the color were black, see setupSpriteTexture()
+            }
+            s->setFloat(Shader::U_BloomScale, bloomScale);
             s->setFloat(Shader::U_BloomShift, TMgr->GlowBloomShift());
         }
         s->setFloat(Shader::U_Flare, flare);
@@ -676,22 +806,7 @@ bool setupGlow(struct view_data* view, std::unique_ptr<TextureManager>& TMgr, fl
     return false;
 }
 
-void RenderRasterize_Shader::render_node_floor_or_ceiling(clipping_window_data* window, polygon_data* polygon,
-                                                          horizontal_surface_data* surface, bool void_present,
-                                                          bool ceil, RenderStep renderStep) {
-
-    float offset = 0;
-
-    const shape_descriptor& texture = AnimTxtr_Translate(surface->texture);
-    float intensity                 = get_light_intensity(surface->lightsource_index) / float(FIXED_ONE - 1);
-    float wobble                    = calcWobble(surface->transfer_mode, view->tick_count);
-    // note: wobble and pulsate behave the same way on floors and ceilings
-    // note 2: stronger wobble looks more like classic with default shaders
-    auto TMgr = setupWallTexture(texture, surface->transfer_mode, wobble * 4.0, 0, intensity, offset, renderStep);
-    if (TMgr->ShapeDesc == UNONE) {
-        return;
-    }
-
+void setupSurfaceBlend(std::unique_ptr<TextureManager>& TMgr, bool void_present) {
     if (TMgr->IsBlended()) {
         glEnable(GL_BLEND);
         setupBlendFunc(TMgr->NormalBlend());
@@ -707,83 +822,214 @@ void RenderRasterize_Shader::render_node_floor_or_ceiling(clipping_window_data*
         glDisable(GL_BLEND);
         glDisable(GL_ALPHA_TEST);
     }
+}
 
-    short vertex_count = polygon->vertex_count;
+SurfaceBucket* RenderRasterize_Shader::find_bucket(const SurfaceBucket& key, RenderStep renderStep) {
+    for (size_t i = 0; i < batch->used; ++i) {
+        SurfaceBucket& bucket = batch->buckets[i];
+        if (bucket.texture == key.texture && bucket.transfer_mode == key.transfer_mode
+            && bucket.horizontal == key.horizontal && bucket.void_present == key.void_present
+            && same_clipping(bucket.window, key.window)) {
+            // joining an earlier blended bucket would draw this surface out of order
+            if (!bucket.blended || i == batch->last_blended) {
+                return &bucket;
+            }
+        }
+    }
 
-    if (vertex_count) {
-        clip_to_window(window);
+    // only the texture's size and opacity are needed now; flush_batch() sets it up again to draw
+    auto TMgr = setupWallTexture(key.texture, key.transfer_mode, key.pulsate, key.wobble, 1, key.offset, renderStep);
+    Shader::disable();
+    if (TMgr->ShapeDesc == UNONE) {
+        return nullptr;
+    }
+    TMgr->RestoreTextureMatrix();
 
-        world_distance x = 0.0, y = 0.0;
-        instantiate_transfer_mode(view, surface->transfer_mode, x, y);
+    if (batch->used == batch->buckets.size()) {
+        batch->buckets.emplace_back();
+    }
+    SurfaceBucket& bucket = batch->buckets[batch->used];
+    bucket.window         = key.window;
+    bucket.texture        = key.texture;
+    bucket.transfer_mode  = key.transfer_mode;
+    bucket.pulsate        = key.pulsate;
+    bucket.wobble         = key.wobble;
+    bucket.glow_wobble    = key.glow_wobble;
+    bucket.offset         = key.offset;
+    bucket.void_present   = key.void_present;
+    bucket.horizontal     = key.horizontal;
+    bucket.tile_ratio     = TMgr->TileRatio();
+    bucket.blended        = TMgr->IsBlended() && !key.void_present; // see setupSurfaceBlend()
+    bucket.firsts.clear();
+    bucket.counts.clear();
+
+    if (bucket.blended) {
+        batch->last_blended = batch->used;
+        batch->any_blended  = true;
+    }
+    ++batch->used;
+    return &bucket;
+}
 
-        vec3 N;
-        vec3 T;
-        float sign;
-        if (ceil) {
-            N    = vec3(0, 0, -1);
-            T    = vec3(0, 1, 0);
-            sign = 1;
-        } else {
-            N    = vec3(0, 0, 1);
-            T    = vec3(0, 1, 0);
-            sign = -1;
-        }
-        glNormal3f(N[0], N[1], N[2]);
-        glMultiTexCoord4fARB(GL_TEXTURE1_ARB, T[0], T[1], T[2], sign);
-
-        GLfloat vertex_array[MAXIMUM_VERTICES_PER_POLYGON * 3];
-        GLfloat texcoord_array[MAXIMUM_VERTICES_PER_POLYGON * 2];
-
-        GLfloat* vp = vertex_array;
-        GLfloat* tp = texcoord_array;
-        float scale;
-
-        switch (surface->transfer_mode) {
-            case _xfer_2x:
-                scale = 2 * WORLD_ONE * TMgr->TileRatio();
-                break;
-            case _xfer_4x:
-                scale = 4 * WORLD_ONE * TMgr->TileRatio();
-                break;
-            default:
-                scale = WORLD_ONE * TMgr->TileRatio();
-                break;
-        }
+void RenderRasterize_Shader::add_to_bucket(SurfaceBucket* bucket, GLint first, GLsizei count) {
+    // surfaces stored in drawing order end up next to each other
+    if (!bucket->firsts.empty() && bucket->firsts.back() + bucket->counts.back() == first) {
+        bucket->counts.back() += count;
+    } else {
+        bucket->firsts.push_back(first);
+        bucket->counts.push_back(count);
+    }
+}
 
-        if (ceil) {
-            for (short i = 0; i < vertex_count; ++i) {
-                world_point2d vertex = get_endpoint_data(polygon->endpoint_indexes[vertex_count - 1 - i])->vertex;
-                *vp++                = vertex.x;
-                *vp++                = vertex.y;
-                *vp++                = surface->height;
-                *tp++                = (vertex.x + surface->origin.x + x) / scale;
-                *tp++                = (vertex.y + surface->origin.y + y) / scale;
-            }
-        } else {
-            for (short i = 0; i < vertex_count; ++i) {
-                world_point2d vertex = get_endpoint_data(polygon->endpoint_indexes[i])->vertex;
-                *vp++                = vertex.x;
-                *vp++                = vertex.y;
-                *vp++                = surface->height;
-                *tp++                = (vertex.x + surface->origin.x + x) / scale;
-                *tp++                = (vertex.y + surface->origin.y + y) / scale;
+void RenderRasterize_Shader::draw_bucket(SurfaceBucket& bucket, RenderStep renderStep) {
+    auto TMgr = setupWallTexture(bucket.texture, bucket.transfer_mode, bucket.pulsate, bucket.wobble, 1,
+                                 bucket.offset, renderStep);
+    if (TMgr->ShapeDesc == UNONE) {
+        Shader::disable();
+        return;
+    }
+
+    setupSurfaceBlend(TMgr, bucket.void_present);
+    clip_to_window(bucket.window);
+
+    GLsizei draws = static_cast<GLsizei>(bucket.firsts.size());
+    glMultiDrawArrays(GL_TRIANGLES, bucket.firsts.data(), bucket.counts.data(), draws);
+
+    if (setupGlow(view, TMgr, bucket.glow_wobble, 1, weaponFlare, selfLuminosity, bucket.offset, renderStep)) {
+        glMultiDrawArrays(GL_TRIANGLES, bucket.firsts.data(), bucket.counts.data(), draws);
+    }
+
+    Shader::disable();
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void RenderRasterize_Shader::flush_batch(RenderStep renderStep) {
+    if (!batch->used) {
+        return;
+    }
+
+    // infravision colors surfaces by texture, not by light
+    geometry->bind(current_player->infravision_duration == 0);
+
+    for (size_t i = 0; i < batch->used; ++i) {
+        if (!batch->buckets[i].blended) {
+            draw_bucket(batch->buckets[i], renderStep);
+        }
+    }
+    if (batch->any_blended) {
+        for (size_t i = 0; i < batch->used; ++i) {
+            if (batch->buckets[i].blended) {
+                draw_bucket(batch->buckets[i], renderStep);
             }
         }
-        glVertexPointer(3, GL_FLOAT, 0, vertex_array);
-        glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array);
+    }
 
-        glDrawArrays(GL_POLYGON, 0, vertex_count);
+    geometry->unbind();
 
-        // see note 2 above; pulsate uniform should stay set from setupWall call
-        if (setupGlow(view, TMgr, 0, intensity, weaponFlare, selfLuminosity, offset, renderStep)) {
-            glDrawArrays(GL_POLYGON, 0, vertex_count);
-        }
+    // whatever comes next sets up its own clipping
+    glDisable(GL_CLIP_PLANE0);
+    glDisable(GL_CLIP_PLANE1);
 
-        Shader::disable();
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
+    batch->used        = 0;
+    batch->any_blended = false;
+}
+
+void RenderRasterize_Shader::render_node_floor_or_ceiling(clipping_window_data* window, polygon_data* polygon,
+                                                          horizontal_surface_data* surface, bool void_present,
+                                                          bool ceil, RenderStep renderStep) {
+
+    float offset = 0;
+
+    short vertex_count = polygon->vertex_count;
+    if (vertex_count < 3) {
+        return;
+    }
+
+    const shape_descriptor& texture = AnimTxtr_Translate(surface->texture);
+    float intensity                 = get_light_intensity(surface->lightsource_index) / float(FIXED_ONE - 1);
+
+    // note: wobble and pulsate behave the same way on floors and ceilings
+    // note 2: stronger wobble looks more like classic with default shaders
+    SurfaceBucket key;
+    key.window        = window;
+    key.texture       = texture;
+    key.transfer_mode = surface->transfer_mode;
+    key.pulsate       = calcWobble(surface->transfer_mode, view->tick_count) * 4.0;
+    key.wobble        = 0;
+    key.glow_wobble   = 0; // see note 2 above; pulsate uniform stays set from setupWall call
+    key.offset        = offset;
+    key.void_present  = void_present;
+    key.horizontal    = true;
+
+    SurfaceBucket* bucket = find_bucket(key, renderStep);
+    if (!bucket) {
+        return;
+    }
+
+    world_distance x = 0.0, y = 0.0;
+    instantiate_transfer_mode(view, surface->transfer_mode, x, y);
+
+    vec3 N;
+    vec3 T;
+    float sign;
+    if (ceil) {
+        N    = vec3(0, 0, -1);
+        T    = vec3(0, 1, 0);
+        sign = 1;
+    } else {
+        N    = vec3(0, 0, 1);
+        T    = vec3(0, 1, 0);
+        sign = -1;
+    }
+
+    float scale;
+    switch (surface->transfer_mode) {
+        case _xfer_2x:
+            scale = 2 * WORLD_ONE * bucket->tile_ratio;
+            break;
+        case _xfer_4x:
+            scale = 4 * WORLD_ONE * bucket->tile_ratio;
+            break;
+        default:
+            scale = WORLD_ONE * bucket->tile_ratio;
+            break;
+    }
+
+    GeometryVertex corners[MAXIMUM_VERTICES_PER_POLYGON];
+    for (short i = 0; i < vertex_count; ++i) {
+        short endpoint         = polygon->endpoint_indexes[ceil ? vertex_count - 1 - i : i];
+        world_point2d vertex   = get_endpoint_data(endpoint)->vertex;
+        GeometryVertex& corner = corners[i];
+        corner.position[0]     = vertex.x;
+        corner.position[1]     = vertex.y;
+        corner.position[2]     = surface->height;
+        corner.texcoord[0]     = (vertex.x + surface->origin.x + x) / scale;
+        corner.texcoord[1]     = (vertex.y + surface->origin.y + y) / scale;
+        corner.normal[0]       = N[0];
+        corner.normal[1]       = N[1];
+        corner.normal[2]       = N[2];
+        corner.tangent[0]      = T[0];
+        corner.tangent[1]      = T[1];
+        corner.tangent[2]      = T[2];
+        corner.tangent[3]      = sign;
+        corner.color[0]        = intensity;
+        corner.color[1]        = intensity;
+        corner.color[2]        = intensity;
     }
+
+    // polygons are convex, so a fan covers them
+    GeometryVertex triangles[(MAXIMUM_VERTICES_PER_POLYGON - 2) * 3];
+    GLsizei count = 0;
+    for (short i = 1; i + 1 < vertex_count; ++i) {
+        triangles[count++] = corners[0];
+        triangles[count++] = corners[i];
+        triangles[count++] = corners[i + 1];
+    }
+
+    size_t slot = 4 * static_cast<size_t>(polygon - map_polygons) + (ceil ? 1 : 0) + (void_present ? 0 : 2);
+    add_to_bucket(bucket, geometry->store_polygon_surface(slot, triangles, count), count);
 }
 
 void RenderRasterize_Shader::render_node_side(clipping_window_data* window, vertical_surface_data* surface,
@@ -794,127 +1040,108 @@ void RenderRasterize_Shader::render_node_side(clipping_window_data* window, vert
         offset = -2.0;
     }
 
+    world_distance h = MIN(surface->h1, surface->hmax);
+    if (h <= surface->h0) {
+        return;
+    }
+
     const shape_descriptor& texture = AnimTxtr_Translate(surface->texture_definition->texture);
     float intensity = (get_light_intensity(surface->lightsource_index) + surface->ambient_delta) / float(FIXED_ONE - 1);
-    float wobble    = calcWobble(surface->transfer_mode, view->tick_count);
-    float pulsate   = 0;
+
+    float wobble  = calcWobble(surface->transfer_mode, view->tick_count);
+    float pulsate = 0;
     if (surface->transfer_mode == _xfer_pulsate) {
         pulsate = wobble;
         wobble  = 0;
     }
-    auto TMgr = setupWallTexture(texture, surface->transfer_mode, pulsate, wobble, intensity, offset, renderStep);
-    if (TMgr->ShapeDesc == UNONE) {
-        return;
-    }
-
-    if (TMgr->IsBlended()) {
-        glEnable(GL_BLEND);
-        setupBlendFunc(TMgr->NormalBlend());
-        glEnable(GL_ALPHA_TEST);
-        glAlphaFunc(GL_GREATER, 0.001);
-    } else {
-        glDisable(GL_BLEND);
-        glEnable(GL_ALPHA_TEST);
-        glAlphaFunc(GL_GREATER, 0.5);
-    }
 
-    if (void_present && TMgr->IsBlended()) {
-        glDisable(GL_BLEND);
-        glDisable(GL_ALPHA_TEST);
+    SurfaceBucket key;
+    key.window        = window;
+    key.texture       = texture;
+    key.transfer_mode = surface->transfer_mode;
+    key.pulsate       = pulsate;
+    key.wobble        = wobble;
+    key.glow_wobble   = wobble;
+    key.offset        = offset;
+    key.void_present  = void_present;
+    key.horizontal    = false;
+
+    SurfaceBucket* bucket = find_bucket(key, renderStep);
+    if (!bucket) {
+        return;
     }
 
-    world_distance h = MIN(surface->h1, surface->hmax);
-
-    if (h > surface->h0) {
-
-        world_point2d vertex[2];
-        uint16 flags;
-        flagged_world_point3d vertices[MAXIMUM_VERTICES_PER_WORLD_POLYGON];
-        short vertex_count;
-
-        /* initialize the two posts of our trapezoid */
-        vertex_count = 2;
-        long_to_overflow_short_2d(surface->p0, vertex[0], flags);
-        long_to_overflow_short_2d(surface->p1, vertex[1], flags);
-
-        if (vertex_count) {
-            clip_to_window(window);
-
-            vertex_count  = 4;
-            vertices[0].z = vertices[1].z = h + view->origin.z;
-            vertices[2].z = vertices[3].z = surface->h0 + view->origin.z;
-            vertices[0].x = vertices[3].x = vertex[0].x, vertices[0].y = vertices[3].y = vertex[0].y;
-            vertices[1].x = vertices[2].x = vertex[1].x, vertices[1].y = vertices[2].y = vertex[1].y;
-            vertices[0].flags = vertices[3].flags = 0;
-            vertices[1].flags = vertices[2].flags = 0;
-
-            uint16 div;
-            switch (surface->transfer_mode) {
-                case _xfer_2x:
-                    div = 2 * WORLD_ONE * TMgr->TileRatio();
-                    break;
-                case _xfer_4x:
-                    div = 4 * WORLD_ONE * TMgr->TileRatio();
-                    break;
-                default:
-                    div = WORLD_ONE * TMgr->TileRatio();
-                    ;
-                    break;
-            }
-
-            double dx = (surface->p1.i - surface->p0.i) / double(surface->length);
-            double dy = (surface->p1.j - surface->p0.j) / double(surface->length);
+    world_point2d vertex[2];
+    uint16 flags;
+    flagged_world_point3d vertices[4];
 
-            world_distance x0 = surface->texture_definition->x0 % div;
-            world_distance y0 = surface->texture_definition->y0 % div;
+    /* initialize the two posts of our trapezoid */
+    long_to_overflow_short_2d(surface->p0, vertex[0], flags);
+    long_to_overflow_short_2d(surface->p1, vertex[1], flags);
 
-            double tOffset = surface->h1 + view->origin.z + y0;
+    vertices[0].z = vertices[1].z = h + view->origin.z;
+    vertices[2].z = vertices[3].z = surface->h0 + view->origin.z;
+    vertices[0].x = vertices[3].x = vertex[0].x, vertices[0].y = vertices[3].y = vertex[0].y;
+    vertices[1].x = vertices[2].x = vertex[1].x, vertices[1].y = vertices[2].y = vertex[1].y;
 
-            vec3 N(-dy, dx, 0);
-            vec3 T(dx, dy, 0);
-            float sign = 1;
-            glNormal3f(N[0], N[1], N[2]);
-            glMultiTexCoord4fARB(GL_TEXTURE1_ARB, T[0], T[1], T[2], sign);
-
-            world_distance x = 0.0, y = 0.0;
-            instantiate_transfer_mode(view, surface->transfer_mode, x, y);
-
-            x0      -= x;
-            tOffset -= y;
+    uint16 div;
+    switch (surface->transfer_mode) {
+        case _xfer_2x:
+            div = 2 * WORLD_ONE * bucket->tile_ratio;
+            break;
+        case _xfer_4x:
+            div = 4 * WORLD_ONE * bucket->tile_ratio;
+            break;
+        default:
+            div = WORLD_ONE * bucket->tile_ratio;
+            break;
+    }
 
-            GLfloat vertex_array[12];
-            GLfloat texcoord_array[8];
+    double dx = (surface->p1.i - surface->p0.i) / double(surface->length);
+    double dy = (surface->p1.j - surface->p0.j) / double(surface->length);
 
-            GLfloat* vp = vertex_array;
-            GLfloat* tp = texcoord_array;
+    world_distance x0 = surface->texture_definition->x0 % div;
+    world_distance y0 = surface->texture_definition->y0 % div;
 
-            for (int i = 0; i < vertex_count; ++i) {
-                float p2 = 0;
-                if (i == 1 || i == 2) {
-                    p2 = surface->length;
-                }
+    double tOffset = surface->h1 + view->origin.z + y0;
 
-                *vp++ = vertices[i].x;
-                *vp++ = vertices[i].y;
-                *vp++ = vertices[i].z;
-                *tp++ = (tOffset - vertices[i].z) / static_cast<float>(div);
-                *tp++ = (x0 + p2) / static_cast<float>(div);
-            }
-            glVertexPointer(3, GL_FLOAT, 0, vertex_array);
-            glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array);
+    vec3 N(-dy, dx, 0);
+    vec3 T(dx, dy, 0);
+    float sign = 1;
 
-            glDrawArrays(GL_QUADS, 0, vertex_count);
+    world_distance x = 0.0, y = 0.0;
+    instantiate_transfer_mode(view, surface->transfer_mode, x, y);
 
-            if (setupGlow(view, TMgr, wobble, intensity, weaponFlare, selfLuminosity, offset, renderStep)) {
-                glDrawArrays(GL_QUADS, 0, vertex_count);
-            }
+    x0      -= x;
+    tOffset -= y;
 
-            Shader::disable();
-            glMatrixMode(GL_TEXTURE);
-            glLoadIdentity();
-            glMatrixMode(GL_MODELVIEW);
+    GeometryVertex corners[4];
+    for (int i = 0; i < 4; ++i) {
+        float p2 = 0;
+        if (i == 1 || i == 2) {
+            p2 = surface->length;
         }
+
+        GeometryVertex& corner = corners[i];
+        corner.position[0]     = vertices[i].x;
+        corner.position[1]     = vertices[i].y;
+        corner.position[2]     = vertices[i].z;
+        corner.texcoord[0]     = (tOffset - vertices[i].z) / static_cast<float>(div);
+        corner.texcoord[1]     = (x0 + p2) / static_cast<float>(div);
+        corner.normal[0]       = N[0];
+        corner.normal[1]       = N[1];
+        corner.normal[2]       = N[2];
+        corner.tangent[0]      = T[0];
+        corner.tangent[1]      = T[1];
+        corner.tangent[2]      = T[2];
+        corner.tangent[3]      = sign;
+        corner.color[0]        = intensity;
+        corner.color[1]        = intensity;
+        corner.color[2]        = intensity;
     }
+
+    GeometryVertex triangles[6] = {corners[0], corners[1], corners[2], corners[0], corners[2], corners[3]};
+    add_to_bucket(bucket, geometry->store_side_surface(surface->texture_definition, triangles, 6), 6);
 }
 
 extern void FlatBumpTexture(); // from OGL_Textures.cpp
@@ -956,13 +1183,10 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
 
     Shader* s    = NULL;
     bool canGlow = false;
+    bool unlit   = false;
     if (RenderRectangle.transfer_mode == _static_transfer) {
         flare = -1;
-        if (renderStep == kDiffuse) {
-            s = Shader::get(Shader::S_Invincible);
-        } else {
-            s = Shader::get(Shader::S_InvincibleBloom);
-        }
+        s = stepShader(renderStep, Shader::S_Invincible, Shader::S_InvincibleBloom, Shader::S_InvincibleMRT);
         s->enable();
         s->setFloat(Shader::U_TransferFadeOut,
                     ((float)((uint16)RenderRectangle.transfer_data)) / (float)((int)FIXED_ONE));
@@ -972,11 +1196,7 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
         s = Shader::get(Shader::S_WallInfravision);
     } else if (RenderRectangle.transfer_mode == _tinted_transfer) {
         flare = -1;
-        if (renderStep == kDiffuse) {
-            s = Shader::get(Shader::S_Invisible);
-        } else {
-            s = Shader::get(Shader::S_InvisibleBloom);
-        }
+        s = stepShader(renderStep, Shader::S_Invisible, Shader::S_InvisibleBloom, Shader::S_InvisibleMRT);
         s->enable();
         s->setFloat(Shader::U_Visibility, 1.0 - RenderRectangle.transfer_data / 32.0f);
     } else if (RenderRectangle.transfer_mode == _solid_transfer) {
@@ -985,12 +1205,13 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
         color[2] = 0;
     } else if (RenderRectangle.transfer_mode == _textured_transfer) {
         if (RenderRectangle.flags & _SHADELESS_BIT) {
-            if (renderStep == kDiffuse) {
+            if (renderStep != kGlow) {
                 color[0] = color[1] = color[2] = 1;
             } else {
                 color[0] = color[1] = color[2] = 0;
             }
             flare = -1;
+            unlit = true;
         } else {
             canGlow = true;
         }
@@ -1002,15 +1223,15 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
 
     if (s == NULL) {
         if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap)) {
-            s = Shader::get(renderStep == kGlow ? Shader::S_BumpBloom : Shader::S_Bump);
+            s = stepShader(renderStep, Shader::S_Bump, Shader::S_BumpBloom, Shader::S_BumpMRT);
         } else {
-            s = Shader::get(renderStep == kGlow ? Shader::S_WallBloom : Shader::S_Wall);
+            s = stepShader(renderStep, Shader::S_Wall, Shader::S_WallBloom, Shader::S_WallMRT);
         }
         s->enable();
     }
 
-    if (renderStep == kGlow) {
-        s->setFloat(Shader::U_BloomScale, SkinPtr->BloomScale);
+    if (renderStep != kDiffuse) {
+        s->setFloat(Shader::U_BloomScale, unlit && renderStep == kDiffuseAndGlow ? 0 : SkinPtr->BloomScale);
         s->setFloat(Shader::U_BloomShift, SkinPtr->BloomShift);
     }
     s->setFloat(Shader::U_Flare, flare);
@@ -1074,7 +1295,7 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
 
         s->enable();
         s->setFloat(Shader::U_Glow, SkinPtr->MinGlowIntensity);
-        if (renderStep == kGlow) {
+        if (renderStep != kDiffuse) {
             s->setFloat(Shader::U_BloomScale, SkinPtr->GlowBloomScale);
             s->setFloat(Shader::U_BloomShift, SkinPtr->GlowBloomShift);
         }
@@ -1102,6 +1323,8 @@ bool RenderModel(rectangle_definition& RenderRectangle, short Collection, short
 void RenderRasterize_Shader::render_node_object(render_object_data* object, bool other_side_of_media,
                                                 RenderStep renderStep) {
 
+    flush_batch(renderStep);
+
     if (!object->clipping_windows)
         return;
 
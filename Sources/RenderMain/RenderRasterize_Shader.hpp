@@ -37,10 +37,15 @@
 #ifdef HAVE_OPENGL
 
 class Blur;
+class GeometryCache;
+struct SurfaceBatch;
+struct SurfaceBucket;
 
 class RenderRasterize_Shader : public RenderRasterizerClass {
 
     std::unique_ptr<Blur> blur;
+    std::unique_ptr<GeometryCache> geometry;
+    std::unique_ptr<SurfaceBatch> batch;
     Rasterizer_Shader_Class* RasPtr;
 
     int objectCount;
@@ -64,6 +69,11 @@ class RenderRasterize_Shader : public RenderRasterizerClass {
     virtual void render_node_object(render_object_data* object, bool other_side_of_media, RenderStep renderStep);
 
     virtual void clip_to_window(clipping_window_data* win);
+    bool same_clipping(const clipping_window_data* a, const clipping_window_data* b) const;
+    SurfaceBucket* find_bucket(const SurfaceBucket& key, RenderStep renderStep);
+    void add_to_bucket(SurfaceBucket* bucket, GLint first, GLsizei count);
+    void draw_bucket(SurfaceBucket& bucket, RenderStep renderStep);
+    void flush_batch(RenderStep renderStep);
     virtual void _render_node_object_helper(render_object_data* object, RenderStep renderStep);
 
     void render_viewer_sprite_layer(RenderStep renderStep);
@@ -78,6 +88,9 @@ class RenderRasterize_Shader : public RenderRasterizerClass {
 
     virtual void render_tree(void);
 
+    // Drop all cached world geometry (on map change)
+    void reset_geometry();
+
     bool renders_viewer_sprites_in_tree() { return true; }
 
     std::unique_ptr<TextureManager> setupWallTexture(const shape_descriptor& Texture, short transferMode, float pulsate,
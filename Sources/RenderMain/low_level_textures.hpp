@@ -66,6 +66,14 @@ class texture_constants {
                                        : function<extra1, extra2, 7>         \
                                         params)
 
+/* ---------- screen strips */
+
+// The screen columns [left, right) a call may draw; the software rasterizer splits wide
+// surfaces into strips and draws them on several threads at once
+struct screen_strip {
+    short left, right;
+};
+
 /* ---------- texture horizontal polygon */
 
 #define HORIZONTAL_WIDTH_SHIFT      texture_constants<TEXBITS>::WIDTH_SHIFT
@@ -161,7 +169,8 @@ void inline write_pixel(T* dst, pixel8 pixel, T* shading_table, uint8* opacity_t
 template <typename T, int sw_alpha_blend, int TEXBITS>
 void texture_horizontal_polygon_lines(struct bitmap_definition* texture, struct bitmap_definition* screen,
                                       struct view_data* view, struct _horizontal_polygon_line_data* data, short y0,
-                                      short* x0_table, short* x1_table, short line_count, uint8* opacity_table = 0) {
+                                      short* x0_table, short* x1_table, short line_count, const screen_strip& strip,
+                                      uint8* opacity_table = 0) {
     (void)(view);
 
     pixel32 rmask = 0;
@@ -178,15 +187,20 @@ void texture_horizontal_polygon_lines(struct bitmap_definition* texture, struct
     }
 
     while ((line_count -= 1) >= 0) {
-        short x0 = *x0_table++, x1 = *x1_table++;
+        short x0 = *x0_table++, x1 = MIN(*x1_table++, strip.right);
+
+        uint32 source_x  = data->source_x;
+        uint32 source_y  = data->source_y;
+        uint32 source_dx = data->source_dx;
+        uint32 source_dy = data->source_dy;
+        if (x0 < strip.left) {
+            source_x += (strip.left - x0) * source_dx, source_y += (strip.left - x0) * source_dy;
+            x0        = strip.left;
+        }
 
         T* shading_table     = (T*)data->shading_table;
         T* write             = (T*)screen->row_addresses[y0] + x0;
         pixel8* base_address = texture->row_addresses[0];
-        uint32 source_x      = data->source_x;
-        uint32 source_y      = data->source_y;
-        uint32 source_dx     = data->source_dx;
-        uint32 source_dy     = data->source_dy;
         short count          = x1 - x0;
 
         while ((count -= 1) >= 0) {
@@ -210,19 +224,24 @@ void texture_horizontal_polygon_lines(struct bitmap_definition* texture, struct
 template <typename T>
 void landscape_horizontal_polygon_lines(struct bitmap_definition* texture, struct bitmap_definition* screen,
                                         struct view_data* view, struct _horizontal_polygon_line_data* data, short y0,
-                                        short* x0_table, short* x1_table, short line_count) {
+                                        short* x0_table, short* x1_table, short line_count, const screen_strip& strip) {
     short landscape_texture_width_downshift = 32 - NextLowerExponent(texture->height);
 
     (void)(view);
 
     while ((line_count -= 1) >= 0) {
-        short x0 = *x0_table++, x1 = *x1_table++;
+        short x0 = *x0_table++, x1 = MIN(*x1_table++, strip.right);
+
+        uint32 source_x  = data->source_x;
+        uint32 source_dx = data->source_dx;
+        if (x0 < strip.left) {
+            source_x += (strip.left - x0) * source_dx;
+            x0        = strip.left;
+        }
 
         T* shading_table = (T*)data->shading_table;
         T* write         = (T*)screen->row_addresses[y0] + x0;
         pixel8* read     = texture->row_addresses[data->source_y];
-        uint32 source_x  = data->source_x;
-        uint32 source_dx = data->source_dx;
         short count      = x1 - x0;
 
         while ((count -= 1) >= 0) {
@@ -235,6 +254,19 @@ void landscape_horizontal_polygon_lines(struct bitmap_definition* texture, struc
     }
 }
 
+// Skip a vertical polygon's columns left of the strip and drop those right of it; strips
+// must start on a multiple of 4 columns so texture_vertical_polygon_lines() groups the
+// same columns together (and so draws the same pixels) whichever strip it is given.
+inline void clip_vertical_polygon_lines(const screen_strip& strip, int& x, int& line_count,
+                                        _vertical_polygon_line_data*& line, short*& y0_table, short*& y1_table) {
+    int skip    = MIN(MAX(strip.left - x, 0), line_count);
+    x          += skip;
+    line       += skip;
+    y0_table   += skip;
+    y1_table   += skip;
+    line_count  = MAX(0, MIN(line_count - skip, strip.right - x));
+}
+
 template <typename T, bool check_transparent>
 void inline copy_check_transparent(T* dst, pixel8 read, T* shading_table) {
     if (!check_transparent || read != 0) {
@@ -245,7 +277,7 @@ void inline copy_check_transparent(T* dst, pixel8 read, T* shading_table) {
 template <typename T, int sw_alpha_blend, bool check_transparent>
 void texture_vertical_polygon_lines(struct bitmap_definition* screen, struct view_data* view,
                                     struct _vertical_polygon_data* data, short* y0_table, short* y1_table,
-                                    uint8* opacity_table = 0) {
+                                    const screen_strip& strip, uint8* opacity_table = 0) {
     struct _vertical_polygon_line_data* line = (struct _vertical_polygon_line_data*)(data + 1);
     int bytes_per_row                        = screen->bytes_per_row;
     int downshift                            = data->downshift;
@@ -256,6 +288,8 @@ void texture_vertical_polygon_lines(struct bitmap_definition* screen, struct vie
 
     (void)(view);
 
+    clip_vertical_polygon_lines(strip, x, line_count, line, y0_table, y1_table);
+
     pixel32 rmask = 0;
     pixel32 gmask = 0;
     pixel32 bmask = 0;
@@ -494,7 +528,7 @@ inline pixel32 get_pixel_tint(pixel32 pixel, void* tint_tables_pv, SDL_PixelForm
 template <typename T>
 void tint_vertical_polygon_lines(struct bitmap_definition* screen, struct view_data* view,
                                  struct _vertical_polygon_data* data, short* y0_table, short* y1_table,
-                                 uint16 transfer_data) {
+                                 const screen_strip& strip, uint16 transfer_data) {
     short tint_table_index                   = transfer_data & 0xff;
     struct _vertical_polygon_line_data* line = (struct _vertical_polygon_line_data*)(data + 1);
     short bytes_per_row                      = screen->bytes_per_row;
@@ -505,6 +539,8 @@ void tint_vertical_polygon_lines(struct bitmap_definition* screen, struct view_d
 
     (void)(view);
 
+    clip_vertical_polygon_lines(strip, x, line_count, line, y0_table, y1_table);
+
     extern SDL_Surface* world_pixels;
 
     fc_assert(tint_table_index >= 0 && tint_table_index < number_of_shading_tables);
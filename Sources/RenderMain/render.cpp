@@ -38,6 +38,7 @@
 
 // LP additions
 #include "AnimatedTextures.hpp"
+#include "Tracing.hpp"
 #include "dynamic_limits.hpp"
 #ifdef HAVE_OPENGL
 #include "OGL_Render.hpp"
@@ -178,6 +179,8 @@ void allocate_render_memory(void) {
     RenderPlaceObjs.RSPtr = &RenderSortPoly;
 #ifdef HAVE_OPENGL
     Render_Classic.RSPtr = Render_Shader.RSPtr = &RenderSortPoly;
+    // new map: cached wall and floor geometry belongs to the old one
+    Render_Shader.reset_geometry();
 #else
     Render_Classic.RSPtr = &RenderSortPoly;
 #endif
@@ -238,6 +241,8 @@ void initialize_view_data(struct view_data* view, bool ignore_preferences) {
 
 /* origin,origin_polygon_index,yaw,pitch,roll,etc. have probably changed since last call */
 void render_view(struct view_data* view, struct bitmap_definition* software_render_dest) {
+    TRACE_FRAME();
+    TRACE_SCOPE("render_view");
     update_view_data(view);
 
     /* clear the render flags */
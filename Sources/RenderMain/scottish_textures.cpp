@@ -48,6 +48,7 @@ not only that, but texture_horizontal_polygon() is actually faster than texture_
 #include <stdlib.h>
 
 #include "SW_Texture_Extras.hpp"
+#include "WorkerPool.hpp"
 #include "preferences.hpp"
 
 
@@ -116,6 +117,37 @@ static void calculate_shading_table(void*& result, view_data* view, void* shadin
 static short *scratch_table0 = NULL, *scratch_table1 = NULL;
 static void* precalculation_table = NULL;
 
+/* ---------- screen strips */
+
+// narrower surfaces aren't worth handing to another thread
+#define MINIMUM_STRIP_WIDTH 64
+
+static WorkerPool* strip_workers = NULL;
+
+/* draw columns [x0, x1) of a surface, split into strips on several threads if it is wide enough.
+    a strip draws exactly the pixels the whole surface would have drawn there, and every strip is
+    done before we return, so the frame comes out the same as drawing everything on one thread. */
+template <typename Draw>
+static void draw_in_strips(short x0, short x1, bool splittable, const Draw& draw) {
+    if (!strip_workers)
+        strip_workers = new WorkerPool(WorkerPool::default_thread_count());
+
+    int strip_count = splittable ? MIN(strip_workers->concurrency(), (x1 - x0) / MINIMUM_STRIP_WIDTH) : 1;
+    if (strip_count <= 1) {
+        draw(screen_strip{x0, x1});
+        return;
+    }
+
+    /* strips start on multiples of 4 columns (see clip_vertical_polygon_lines) */
+    short first_x     = x0 & ~3;
+    short strip_width = ((x1 - first_x) / strip_count + 3) & ~3;
+    strip_workers->run(strip_count, [&](int i) {
+        short left  = (i == 0) ? x0 : first_x + i * strip_width;
+        short right = (i == strip_count - 1) ? x1 : first_x + (i + 1) * strip_width;
+        draw(screen_strip{left, MIN(right, x1)});
+    });
+}
+
 /* ---------- private prototypes */
 
 template <int TEXBITS>
@@ -135,6 +167,15 @@ static void _prelandscape_horizontal_polygon_lines(struct polygon_definition* po
                                                    struct view_data* view, struct _horizontal_polygon_line_data* data,
                                                    short y0, short* x0_table, short* x1_table, short line_count);
 
+static void draw_horizontal_polygon_lines(struct polygon_definition* polygon, struct bitmap_definition* screen,
+                                          struct view_data* view, short y0, short* left_table, short* right_table,
+                                          short line_count, const screen_strip& strip);
+static void draw_vertical_polygon_lines(struct polygon_definition* polygon, struct bitmap_definition* screen,
+                                        struct view_data* view, short* left_table, short* right_table,
+                                        const screen_strip& strip);
+static void draw_rectangle_lines(struct rectangle_definition* rectangle, struct bitmap_definition* screen,
+                                 struct view_data* view, const screen_strip& strip);
+
 /* ---------- code */
 
 /* set aside memory at launch for two line tables (remember, we precalculate all the y-values
@@ -160,8 +201,10 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
         return;
     }
 
-    /* locate the vertically highest (closest to zero) and lowest (farthest from zero) vertices */
+    /* locate the vertically highest (closest to zero) and lowest (farthest from zero) vertices,
+        and the horizontal extent */
     highest_vertex = lowest_vertex = 0;
+    short left_x = vertices[0].x, right_x = vertices[0].x;
     for (vertex = 0; vertex < polygon->vertex_count; ++vertex) {
         if (!(vertices[vertex].x >= 0 && vertices[vertex].x <= screen->width && vertices[vertex].y >= 0
               && vertices[vertex].y <= screen->height)) {
@@ -173,6 +216,8 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
             highest_vertex = vertex;
         else if (vertices[vertex].y > vertices[lowest_vertex].y)
             lowest_vertex = vertex;
+        left_x  = MIN(left_x, vertices[vertex].x);
+        right_x = MAX(right_x, vertices[vertex].x);
     }
 
     /* if this polygon is not a horizontal line, draw it */
@@ -260,122 +305,10 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
         }
 
         /* render all lines */
-        switch (bit_depth) {
-            case 8:
-                switch (polygon->transfer_mode) {
-
-                    case _textured_transfer:
-                        TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel8, _sw_alpha_off,
-                                           (polygon->texture, screen, view,
-                                            (struct _horizontal_polygon_line_data*)precalculation_table,
-                                            vertices[highest_vertex].y, left_table, right_table,
-                                            aggregate_total_line_count));
-                        break;
-                    case _big_landscaped_transfer:
-                        landscape_horizontal_polygon_lines<pixel8>(
-                                polygon->texture, screen, view,
-                                (struct _horizontal_polygon_line_data*)precalculation_table, vertices[highest_vertex].y,
-                                left_table, right_table, aggregate_total_line_count);
-                        break;
-
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            case 16:
-                switch (polygon->transfer_mode) {
-                    case _textured_transfer: {
-                        SW_Texture* sw_texture = 0;
-                        if (graphics_preferences->software_alpha_blending) {
-                            sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
-                        }
-                        if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
-                            if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
-                                TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel16,
-                                                   _sw_alpha_fast,
-                                                   (polygon->texture, screen, view,
-                                                    (struct _horizontal_polygon_line_data*)precalculation_table,
-                                                    vertices[highest_vertex].y, left_table, right_table,
-                                                    aggregate_total_line_count));
-                            } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
-                                TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel16,
-                                                   _sw_alpha_nice,
-                                                   (polygon->texture, screen, view,
-                                                    (struct _horizontal_polygon_line_data*)precalculation_table,
-                                                    vertices[highest_vertex].y, left_table, right_table,
-                                                    aggregate_total_line_count, sw_texture->opac_table()));
-                            }
-                        } else {
-                            TEXBITS_DISPATCH_2(
-                                    polygon->texture, texture_horizontal_polygon_lines, pixel16, _sw_alpha_off,
-                                    (polygon->texture, screen, view,
-                                     (struct _horizontal_polygon_line_data*)precalculation_table,
-                                     vertices[highest_vertex].y, left_table, right_table, aggregate_total_line_count));
-                        }
-                    } break;
-
-                    case _big_landscaped_transfer:
-                        landscape_horizontal_polygon_lines<pixel16>(
-                                polygon->texture, screen, view,
-                                (struct _horizontal_polygon_line_data*)precalculation_table, vertices[highest_vertex].y,
-                                left_table, right_table, aggregate_total_line_count);
-                        break;
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            case 32:
-                switch (polygon->transfer_mode) {
-                    case _textured_transfer: {
-                        SW_Texture* sw_texture = 0;
-                        if (graphics_preferences->software_alpha_blending) {
-                            sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
-                        }
-                        if (sw_texture && sw_texture->opac_type() && !polygon->VoidPresent) {
-                            if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
-                                TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel32,
-                                                   _sw_alpha_fast,
-                                                   (polygon->texture, screen, view,
-                                                    (struct _horizontal_polygon_line_data*)precalculation_table,
-                                                    vertices[highest_vertex].y, left_table, right_table,
-                                                    aggregate_total_line_count));
-                            } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
-                                TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel32,
-                                                   _sw_alpha_nice,
-                                                   (polygon->texture, screen, view,
-                                                    (struct _horizontal_polygon_line_data*)precalculation_table,
-                                                    vertices[highest_vertex].y, left_table, right_table,
-                                                    aggregate_total_line_count, sw_texture->opac_table()));
-                            }
-                        } else {
-                            TEXBITS_DISPATCH_2(
-                                    polygon->texture, texture_horizontal_polygon_lines, pixel32, _sw_alpha_off,
-                                    (polygon->texture, screen, view,
-                                     (struct _horizontal_polygon_line_data*)precalculation_table,
-                                     vertices[highest_vertex].y, left_table, right_table, aggregate_total_line_count));
-                        }
-                    } break;
-                    case _big_landscaped_transfer:
-                        landscape_horizontal_polygon_lines<pixel32>(
-                                polygon->texture, screen, view,
-                                (struct _horizontal_polygon_line_data*)precalculation_table, vertices[highest_vertex].y,
-                                left_table, right_table, aggregate_total_line_count);
-                        break;
-
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            default:
-                fc_assert(false);
-                break;
-        }
+        draw_in_strips(left_x, right_x, true, [&](const screen_strip& strip) {
+            draw_horizontal_polygon_lines(polygon, screen, view, vertices[highest_vertex].y, left_table, right_table,
+                                          aggregate_total_line_count, strip);
+        });
     }
 }
 
@@ -484,155 +417,12 @@ void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_
         } else
             VHALT_DEBUG(csprintf(temporary, "vertical_polygons dont support mode #%d", polygon->transfer_mode));
 
-        /* render all lines */
-        switch (bit_depth) {
-            case 8:
-                switch (polygon->transfer_mode) {
-                    case _textured_transfer:
-                        if (polygon->texture->flags & _TRANSPARENT_BIT)
-                            texture_vertical_polygon_lines<pixel8, _sw_alpha_off, true>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table);
-                        else
-                            texture_vertical_polygon_lines<pixel8, _sw_alpha_off, false>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table);
-                        break;
-                    case _static_transfer:
-                        if (polygon->texture->flags & _TRANSPARENT_BIT)
-                            randomize_vertical_polygon_lines<pixel8, true>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        else
-                            randomize_vertical_polygon_lines<pixel8, false>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        break;
-
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            case 16:
-                switch (polygon->transfer_mode) {
-                    case _textured_transfer: {
-                        SW_Texture* sw_texture = 0;
-                        if (graphics_preferences->software_alpha_blending) {
-                            sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
-                        }
-                        if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
-                            if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
-                                if (polygon->texture->flags & _TRANSPARENT_BIT) {
-                                    texture_vertical_polygon_lines<pixel16, _sw_alpha_fast, true>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table);
-                                } else {
-                                    texture_vertical_polygon_lines<pixel16, _sw_alpha_fast, false>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table);
-                                }
-                            } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
-                                if (polygon->texture->flags & _TRANSPARENT_BIT) {
-                                    texture_vertical_polygon_lines<pixel16, _sw_alpha_nice, true>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table, sw_texture->opac_table());
-                                } else {
-                                    texture_vertical_polygon_lines<pixel16, _sw_alpha_nice, false>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table, sw_texture->opac_table());
-                                }
-                            }
-                        } else {
-                            if (polygon->texture->flags & _TRANSPARENT_BIT) {
-                                texture_vertical_polygon_lines<pixel16, _sw_alpha_off, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                        right_table);
-                            } else {
-                                texture_vertical_polygon_lines<pixel16, _sw_alpha_off, false>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                        right_table);
-                            }
-                        }
-                    } break;
-                    case _static_transfer:
-                        if (polygon->texture->flags & _TRANSPARENT_BIT) {
-                            randomize_vertical_polygon_lines<pixel16, true>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        } else {
-                            randomize_vertical_polygon_lines<pixel16, false>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        }
-                        break;
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            case 32:
-                switch (polygon->transfer_mode) {
-                    case _textured_transfer: {
-                        SW_Texture* sw_texture = 0;
-                        if (graphics_preferences->software_alpha_blending) {
-                            sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
-                        }
-                        if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
-                            if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
-                                if (polygon->texture->flags & _TRANSPARENT_BIT)
-                                    texture_vertical_polygon_lines<pixel32, _sw_alpha_fast, true>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table);
-                                else
-                                    texture_vertical_polygon_lines<pixel32, _sw_alpha_fast, false>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table);
-                            } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
-                                if (polygon->texture->flags & _TRANSPARENT_BIT)
-                                    texture_vertical_polygon_lines<pixel32, _sw_alpha_nice, true>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table, sw_texture->opac_table());
-                                else
-                                    texture_vertical_polygon_lines<pixel32, _sw_alpha_nice, false>(
-                                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                            left_table, right_table, sw_texture->opac_table());
-                            }
-                        } else {
-                            if (polygon->texture->flags & _TRANSPARENT_BIT)
-                                texture_vertical_polygon_lines<pixel32, _sw_alpha_off, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                        right_table);
-                            else
-                                texture_vertical_polygon_lines<pixel32, _sw_alpha_off, false>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                        right_table);
-                        }
-                        break;
-                    }
-                    case _static_transfer:
-                        if (polygon->texture->flags & _TRANSPARENT_BIT)
-                            randomize_vertical_polygon_lines<pixel32, true>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        else
-                            randomize_vertical_polygon_lines<pixel32, false>(
-                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
-                                    right_table, polygon->transfer_data);
-                        break;
-
-                    default:
-                        fc_assert(false);
-                        break;
-                }
-                break;
-
-            default:
-                fc_assert(false);
-                break;
-        }
+        /* render all lines (static can't be split up: its noise runs down one column after another) */
+        bool splittable = polygon->transfer_mode != _static_transfer;
+        draw_in_strips(vertices[highest_vertex].x, vertices[lowest_vertex].x, splittable,
+                       [&](const screen_strip& strip) {
+                           draw_vertical_polygon_lines(polygon, screen, view, left_table, right_table, strip);
+                       });
     }
 }
 
@@ -781,95 +571,378 @@ void Rasterizer_SW_Class::texture_rectangle(rectangle_definition& textured_recta
                     fc_assert(y1 <= screen->height);
                 }
 
-                switch (bit_depth) {
-                    case 8:
-                        switch (rectangle->transfer_mode) {
-                            case _textured_transfer:
-                                texture_vertical_polygon_lines<pixel8, _sw_alpha_off, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1);
-                                break;
+                bool splittable = rectangle->transfer_mode != _static_transfer;
+                draw_in_strips(header->x0, header->x0 + header->width, splittable, [&](const screen_strip& strip) {
+                    draw_rectangle_lines(rectangle, screen, view, strip);
+                });
+            }
+        }
+    }
+}
 
-                            case _static_transfer:
-                                randomize_vertical_polygon_lines<pixel8, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
+/* ---------- private code */
 
-                            case _tinted_transfer:
-                                tint_vertical_polygon_lines<pixel8>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
+/* the mode- and depth-specific line mappers for one strip of a precalculated polygon or rectangle */
+static void draw_horizontal_polygon_lines(struct polygon_definition* polygon, struct bitmap_definition* screen,
+                                          struct view_data* view, short y0, short* left_table, short* right_table,
+                                          short line_count, const screen_strip& strip) {
+    switch (bit_depth) {
+        case 8:
+            switch (polygon->transfer_mode) {
+
+                case _textured_transfer:
+                    TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel8, _sw_alpha_off,
+                                       (polygon->texture, screen, view,
+                                        (struct _horizontal_polygon_line_data*)precalculation_table,
+                                        y0, left_table, right_table,
+                                        line_count, strip));
+                    break;
+                case _big_landscaped_transfer:
+                    landscape_horizontal_polygon_lines<pixel8>(
+                            polygon->texture, screen, view,
+                            (struct _horizontal_polygon_line_data*)precalculation_table, y0,
+                            left_table, right_table, line_count, strip);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
 
-                            default:
-                                fc_assert(false);
-                                break;
+        case 16:
+            switch (polygon->transfer_mode) {
+                case _textured_transfer: {
+                    SW_Texture* sw_texture = 0;
+                    if (graphics_preferences->software_alpha_blending) {
+                        sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
+                    }
+                    if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
+                        if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
+                            TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel16,
+                                               _sw_alpha_fast,
+                                               (polygon->texture, screen, view,
+                                                (struct _horizontal_polygon_line_data*)precalculation_table,
+                                                y0, left_table, right_table,
+                                                line_count, strip));
+                        } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
+                            TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel16,
+                                               _sw_alpha_nice,
+                                               (polygon->texture, screen, view,
+                                                (struct _horizontal_polygon_line_data*)precalculation_table,
+                                                y0, left_table, right_table,
+                                                line_count, strip, sw_texture->opac_table()));
                         }
-                        break;
+                    } else {
+                        TEXBITS_DISPATCH_2(
+                                polygon->texture, texture_horizontal_polygon_lines, pixel16, _sw_alpha_off,
+                                (polygon->texture, screen, view,
+                                 (struct _horizontal_polygon_line_data*)precalculation_table,
+                                 y0, left_table, right_table, line_count, strip));
+                    }
+                } break;
+
+                case _big_landscaped_transfer:
+                    landscape_horizontal_polygon_lines<pixel16>(
+                            polygon->texture, screen, view,
+                            (struct _horizontal_polygon_line_data*)precalculation_table, y0,
+                            left_table, right_table, line_count, strip);
+                    break;
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
 
-                    case 16:
-                        switch (rectangle->transfer_mode) {
-                            case _textured_transfer:
-                                texture_vertical_polygon_lines<pixel16, _sw_alpha_off, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1);
-                                break;
+        case 32:
+            switch (polygon->transfer_mode) {
+                case _textured_transfer: {
+                    SW_Texture* sw_texture = 0;
+                    if (graphics_preferences->software_alpha_blending) {
+                        sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
+                    }
+                    if (sw_texture && sw_texture->opac_type() && !polygon->VoidPresent) {
+                        if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
+                            TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel32,
+                                               _sw_alpha_fast,
+                                               (polygon->texture, screen, view,
+                                                (struct _horizontal_polygon_line_data*)precalculation_table,
+                                                y0, left_table, right_table,
+                                                line_count, strip));
+                        } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
+                            TEXBITS_DISPATCH_2(polygon->texture, texture_horizontal_polygon_lines, pixel32,
+                                               _sw_alpha_nice,
+                                               (polygon->texture, screen, view,
+                                                (struct _horizontal_polygon_line_data*)precalculation_table,
+                                                y0, left_table, right_table,
+                                                line_count, strip, sw_texture->opac_table()));
+                        }
+                    } else {
+                        TEXBITS_DISPATCH_2(
+                                polygon->texture, texture_horizontal_polygon_lines, pixel32, _sw_alpha_off,
+                                (polygon->texture, screen, view,
+                                 (struct _horizontal_polygon_line_data*)precalculation_table,
+                                 y0, left_table, right_table, line_count, strip));
+                    }
+                } break;
+                case _big_landscaped_transfer:
+                    landscape_horizontal_polygon_lines<pixel32>(
+                            polygon->texture, screen, view,
+                            (struct _horizontal_polygon_line_data*)precalculation_table, y0,
+                            left_table, right_table, line_count, strip);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
 
-                            case _static_transfer:
-                                randomize_vertical_polygon_lines<pixel16, true>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
+        default:
+            fc_assert(false);
+            break;
+    }
+}
 
-                            case _tinted_transfer:
-                                tint_vertical_polygon_lines<pixel16>(
-                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
+static void draw_vertical_polygon_lines(struct polygon_definition* polygon, struct bitmap_definition* screen,
+                                        struct view_data* view, short* left_table, short* right_table,
+                                        const screen_strip& strip) {
+    switch (bit_depth) {
+        case 8:
+            switch (polygon->transfer_mode) {
+                case _textured_transfer:
+                    if (polygon->texture->flags & _TRANSPARENT_BIT)
+                        texture_vertical_polygon_lines<pixel8, _sw_alpha_off, true>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, strip);
+                    else
+                        texture_vertical_polygon_lines<pixel8, _sw_alpha_off, false>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, strip);
+                    break;
+                case _static_transfer:
+                    if (polygon->texture->flags & _TRANSPARENT_BIT)
+                        randomize_vertical_polygon_lines<pixel8, true>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    else
+                        randomize_vertical_polygon_lines<pixel8, false>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
 
-                            default:
-                                fc_assert(false);
-                                break;
+        case 16:
+            switch (polygon->transfer_mode) {
+                case _textured_transfer: {
+                    SW_Texture* sw_texture = 0;
+                    if (graphics_preferences->software_alpha_blending) {
+                        sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
+                    }
+                    if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
+                        if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
+                            if (polygon->texture->flags & _TRANSPARENT_BIT) {
+                                texture_vertical_polygon_lines<pixel16, _sw_alpha_fast, true>(
+                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                                        left_table, right_table, strip);
+                            } else {
+                                texture_vertical_polygon_lines<pixel16, _sw_alpha_fast, false>(
+                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                                        left_table, right_table, strip);
+                            }
+                        } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
+                            if (polygon->texture->flags & _TRANSPARENT_BIT) {
+                                texture_vertical_polygon_lines<pixel16, _sw_alpha_nice, true>(
+                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                                        left_table, right_table, strip, sw_texture->opac_table());
+                            } else {
+                                texture_vertical_polygon_lines<pixel16, _sw_alpha_nice, false>(
+                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                                        left_table, right_table, strip, sw_texture->opac_table());
+                            }
                         }
-                        break;
+                    } else {
+                        if (polygon->texture->flags & _TRANSPARENT_BIT) {
+                            texture_vertical_polygon_lines<pixel16, _sw_alpha_off, true>(
+                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                    right_table, strip);
+                        } else {
+                            texture_vertical_polygon_lines<pixel16, _sw_alpha_off, false>(
+                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                    right_table, strip);
+                        }
+                    }
+                } break;
+                case _static_transfer:
+                    if (polygon->texture->flags & _TRANSPARENT_BIT) {
+                        randomize_vertical_polygon_lines<pixel16, true>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    } else {
+                        randomize_vertical_polygon_lines<pixel16, false>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    }
+                    break;
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
 
-                    case 32:
-                        switch (rectangle->transfer_mode) {
-                            case _textured_transfer:
-                                texture_vertical_polygon_lines<pixel32, _sw_alpha_off, true>(
+        case 32:
+            switch (polygon->transfer_mode) {
+                case _textured_transfer: {
+                    SW_Texture* sw_texture = 0;
+                    if (graphics_preferences->software_alpha_blending) {
+                        sw_texture = SW_Texture_Extras::instance()->GetTexture(polygon->ShapeDesc);
+                    }
+                    if (sw_texture && !polygon->VoidPresent && sw_texture->opac_type()) {
+                        if (graphics_preferences->software_alpha_blending == _sw_alpha_fast) {
+                            if (polygon->texture->flags & _TRANSPARENT_BIT)
+                                texture_vertical_polygon_lines<pixel32, _sw_alpha_fast, true>(
                                         screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1);
-                                break;
-
-                            case _static_transfer:
-                                randomize_vertical_polygon_lines<pixel32, true>(
+                                        left_table, right_table, strip);
+                            else
+                                texture_vertical_polygon_lines<pixel32, _sw_alpha_fast, false>(
                                         screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
-
-                            case _tinted_transfer:
-                                tint_vertical_polygon_lines<pixel32>(
+                                        left_table, right_table, strip);
+                        } else if (graphics_preferences->software_alpha_blending == _sw_alpha_nice) {
+                            if (polygon->texture->flags & _TRANSPARENT_BIT)
+                                texture_vertical_polygon_lines<pixel32, _sw_alpha_nice, true>(
                                         screen, view, (struct _vertical_polygon_data*)precalculation_table,
-                                        scratch_table0, scratch_table1, rectangle->transfer_data);
-                                break;
-
-                            default:
-                                fc_assert(false);
-                                break;
+                                        left_table, right_table, strip, sw_texture->opac_table());
+                            else
+                                texture_vertical_polygon_lines<pixel32, _sw_alpha_nice, false>(
+                                        screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                                        left_table, right_table, strip, sw_texture->opac_table());
                         }
-                        break;
-
-                    default:
-                        fc_assert(false);
-                        break;
+                    } else {
+                        if (polygon->texture->flags & _TRANSPARENT_BIT)
+                            texture_vertical_polygon_lines<pixel32, _sw_alpha_off, true>(
+                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                    right_table, strip);
+                        else
+                            texture_vertical_polygon_lines<pixel32, _sw_alpha_off, false>(
+                                    screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                    right_table, strip);
+                    }
+                    break;
                 }
+                case _static_transfer:
+                    if (polygon->texture->flags & _TRANSPARENT_BIT)
+                        randomize_vertical_polygon_lines<pixel32, true>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    else
+                        randomize_vertical_polygon_lines<pixel32, false>(
+                                screen, view, (struct _vertical_polygon_data*)precalculation_table, left_table,
+                                right_table, polygon->transfer_data);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
             }
-        }
+            break;
+
+        default:
+            fc_assert(false);
+            break;
     }
 }
 
-/* ---------- private code */
+static void draw_rectangle_lines(struct rectangle_definition* rectangle, struct bitmap_definition* screen,
+                                 struct view_data* view, const screen_strip& strip) {
+    switch (bit_depth) {
+        case 8:
+            switch (rectangle->transfer_mode) {
+                case _textured_transfer:
+                    texture_vertical_polygon_lines<pixel8, _sw_alpha_off, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip);
+                    break;
+
+                case _static_transfer:
+                    randomize_vertical_polygon_lines<pixel8, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, rectangle->transfer_data);
+                    break;
+
+                case _tinted_transfer:
+                    tint_vertical_polygon_lines<pixel8>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip, rectangle->transfer_data);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
+
+        case 16:
+            switch (rectangle->transfer_mode) {
+                case _textured_transfer:
+                    texture_vertical_polygon_lines<pixel16, _sw_alpha_off, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip);
+                    break;
+
+                case _static_transfer:
+                    randomize_vertical_polygon_lines<pixel16, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, rectangle->transfer_data);
+                    break;
+
+                case _tinted_transfer:
+                    tint_vertical_polygon_lines<pixel16>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip, rectangle->transfer_data);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
+
+        case 32:
+            switch (rectangle->transfer_mode) {
+                case _textured_transfer:
+                    texture_vertical_polygon_lines<pixel32, _sw_alpha_off, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip);
+                    break;
+
+                case _static_transfer:
+                    randomize_vertical_polygon_lines<pixel32, true>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, rectangle->transfer_data);
+                    break;
+
+                case _tinted_transfer:
+                    tint_vertical_polygon_lines<pixel32>(
+                            screen, view, (struct _vertical_polygon_data*)precalculation_table,
+                            scratch_table0, scratch_table1, strip, rectangle->transfer_data);
+                    break;
+
+                default:
+                    fc_assert(false);
+                    break;
+            }
+            break;
+
+        default:
+            fc_assert(false);
+            break;
+    }
+}
 
 /* starting at x0 and for line_count vertical lines between *y0 and *y1, precalculate all the
     information _texture_vertical_polygon_lines will need to work */
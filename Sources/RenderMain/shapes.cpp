@@ -39,6 +39,7 @@ too small
 #include <string.h>
 
 #include "FileHandler.hpp"
+#include "LevelPrefetch.hpp"
 #include "collection_definition.hpp"
 #include "game_errors.hpp"
 #include "images.hpp"
@@ -1306,12 +1307,24 @@ void load_replacement_collections() {
     struct collection_header* header;
     short collection_index;
 
+    // have the image files read ahead while they're decoded one by one
+    std::vector<FileSpecifier> files;
+    for (collection_index = 0, header = collection_headers; collection_index < MAXIMUM_COLLECTIONS;
+         ++collection_index, ++header) {
+        if (collection_loaded(header)) {
+            OGL_GetModelsImagesFiles(collection_index, files);
+        }
+    }
+    LevelPrefetch::instance()->prefetch(files);
+
     for (collection_index = 0, header = collection_headers; collection_index < MAXIMUM_COLLECTIONS;
          ++collection_index, ++header) {
         if (collection_loaded(header)) {
             OGL_LoadModelsImages(collection_index);
         }
     }
+
+    LevelPrefetch::instance()->finish();
 }
 
 #endif
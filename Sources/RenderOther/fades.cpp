@@ -313,7 +313,13 @@ void set_fade_effect(short type) {
     }
 }
 
-void start_fade(short type) { explicit_start_fade(type, world_color_table, visible_color_table, true); }
+void start_fade(short type) {
+    // otherwise a predicted hit flashes the screen twice
+    if (world_update_is_predictive())
+        return;
+
+    explicit_start_fade(type, world_color_table, visible_color_table, true);
+}
 
 void explicit_start_fade(short type, struct color_table* original_color_table, struct color_table* animated_color_table,
                          bool game_in_progress) {
@@ -140,12 +140,18 @@ static void apply_gamma(SDL_Surface* src, SDL_Surface* dst);
 static void update_screen(SDL_Rect& source, SDL_Rect& destination, bool hi_rez, bool every_other_line);
 static void update_fps_display(SDL_Surface* s);
 static void DisplayPosition(SDL_Surface* s);
+static void DisplayTrace(SDL_Surface* s);
 static void DisplayMessages(SDL_Surface* s);
 static void DrawSurface(SDL_Surface* s, SDL_Rect& dest_rect, SDL_Rect& src_rect);
 static void clear_screen_margin();
 
 SDL_PixelFormat pixel_format_16, pixel_format_32;
 
+#ifdef HAVE_OPENGL
+// film export renders as fast as it can, so it never waits for the display, whatever the preference says
+static bool vsync_wanted() { return Get_OGL_ConfigureData().WaitForVSync && shell_options.export_film.empty(); }
+#endif
+
 static bitmap_definition_buffer bitmap_definition_of_sdl_surface(const SDL_Surface* surface) {
     assert(surface);
     bitmap_definition_buffer buf(/*row_count:*/ surface->h);
@@ -694,7 +700,7 @@ static bool need_mode_change(int window_width, int window_height, int log_width,
                 SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, want_samples);
         }
 
-        int want_vsync = Get_OGL_ConfigureData().WaitForVSync ? 1 : 0;
+        int want_vsync = vsync_wanted() ? 1 : 0;
         int has_vsync  = SDL_GL_GetSwapInterval();
         if ((has_vsync == 0) != (want_vsync == 0))
             SDL_GL_SetSwapInterval(want_vsync);
@@ -827,7 +833,7 @@ static void change_screen_mode(int width, int height, int depth, bool nogl, bool
                 SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
                 SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
             }
-            SDL_GL_SetSwapInterval(Get_OGL_ConfigureData().WaitForVSync ? 1 : 0);
+            SDL_GL_SetSwapInterval(vsync_wanted() ? 1 : 0);
         }
 #endif
 
@@ -1364,6 +1370,7 @@ void render_screen(short ticks_elapsed) {
             update_fps_display(disp_pixels);
         }
         DisplayPosition(disp_pixels);
+        DisplayTrace(disp_pixels);
         DisplayScores(disp_pixels);
     }
     DisplayMessages(disp_pixels);
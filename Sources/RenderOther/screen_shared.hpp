@@ -48,6 +48,7 @@ extern SDL_Surface* world_pixels;
 #define DEFAULT_WORLD_HEIGHT 320
 
 #include "Console.hpp"
+#include "Tracing.hpp"
 #include "screen_drawing.hpp"
 
 #include "Image_Blitter.hpp"
@@ -591,6 +592,31 @@ static void DisplayPosition(SDL_Surface* s) {
     DisplayText(X, Y, temporary);
 }
 
+static void DisplayTrace(SDL_Surface* s) {
+#ifdef AB_TRACING
+    if (!Tracer::instance()->overlay_visible())
+        return;
+
+    FontSpecifier& Font = GetOnScreenFont();
+
+    DisplayTextDest  = s;
+    DisplayTextFont  = Font.Info;
+    DisplayTextStyle = Font.Style;
+
+    auto text_margins = alephbet::Screen::instance()->lua_text_margins;
+    short LineSpacing = Font.LineSpacing;
+    short X0          = s->w - text_margins.right - LineSpacing / 3;
+    short Y           = text_margins.top + LineSpacing;
+
+    // right-aligned, averaged over the last second of game time
+    for (const auto& average : Tracer::instance()->averages(TICKS_PER_SECOND)) {
+        sprintf(temporary, "%s %6.2f ms", average.first, average.second);
+        DisplayText(X0 - DisplayTextWidth(temporary), Y, temporary);
+        Y += LineSpacing;
+    }
+#endif
+}
+
 static void DisplayInputLine(SDL_Surface* s) {
     if (Console::instance()->input_active() && !Console::instance()->displayBuffer().empty()) {
         FontSpecifier& Font = GetOnScreenFont();
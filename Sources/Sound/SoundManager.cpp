@@ -22,15 +22,22 @@
  *
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
-#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "InfoTree.hpp"
 #include "Movie.hpp"
 #include "OpenALManager.hpp"
+#include "PairOfShortsHash.hpp"
 #include "ReplacementSounds.hpp"
 #include "SoundManager.hpp"
 #include "images.hpp"
+#include "map.hpp"
 #include "shell_options.hpp"
 #include "sound_definitions.hpp"
 
@@ -44,42 +51,58 @@
 #define MARK_SLOT_AS_FREE(o) ((o)->flags &= (uint16)~0x8000)
 #define MARK_SLOT_AS_USED(o) ((o)->flags |= (uint16)0x8000)
 
+// Keeps loaded sounds under a byte budget, dropping the least recently played first,
+// and decodes external replacement sounds on a thread of its own
 class SoundMemoryManager {
   public:
 
-    SoundMemoryManager(std::size_t max_size) : m_size(0), m_max_size(max_size) {}
+    SoundMemoryManager(std::size_t max_size)
+        : m_size(0), m_max_size(max_size), m_newest(nullptr), m_oldest(nullptr), m_next_ticket(0), m_quit(false),
+          m_has_decoded(false) {}
+
+    ~SoundMemoryManager() { StopLoader(); }
 
     void SetMaxSize(std::size_t max_size) { m_max_size = max_size; }
 
-    void Add(std::shared_ptr<SoundData> data, short index, short slot);
+    void Add(const Sound& sound, short index, short slot);
 
-    std::shared_ptr<SoundData> Get(short index, short slot) { return m_entries[index].data[slot]; }
+    Sound Get(short index, short slot) {
+        auto it = m_entries.find(index);
+        return it != m_entries.end() ? it->second.sounds[slot] : Sound();
+    }
 
     void Update(short index);
     std::function<void(short)> SoundReleased;
 
     bool IsLoaded(short index) { return m_entries.count(index); }
 
-    void Clear() {
-        m_entries.clear();
-        m_size = 0;
-    }
+    void Clear();
+
+    void Release(short index);
+
+    // Queues a replacement sound for decoding; it's added with Add() by the first
+    // SwapInDecoded() after it's ready, unless the sound is released before then
+    void Decode(const FileSpecifier& file, short index, short slot);
+    void SwapInDecoded();
 
-    void Release(short index); // sound must be loaded
+    void StopLoader();
 
   private:
 
     struct Entry {
-        Entry() : data(5), last_played(0) {}
+        Entry(short index)
+            : sounds(SoundDefinition::MAXIMUM_PERMUTATIONS_PER_SOUND), index(index), newer(nullptr), older(nullptr) {}
 
-        std::vector<std::shared_ptr<SoundData>> data;
-        uint32 last_played;
+        std::vector<Sound> sounds;
+        short index;
+        Entry* newer; // links in the order the sounds were last played
+        Entry* older;
 
         std::size_t size() {
             std::size_t n = 0;
-            for (std::vector<std::shared_ptr<SoundData>>::iterator it = data.begin(); it != data.end(); ++it) {
-                if (it->get()) {
-                    n += (*it)->size();
+            for (auto& sound : sounds) {
+                if (sound.data.get()) {
+                    n += sound.data->size();
                 }
             }
 
@@ -87,51 +110,210 @@ class SoundMemoryManager {
         }
     };
 
-    void ReleaseOldestSound();
-    std::map<short, Entry> m_entries;
+    struct DecodeRequest {
+        FileSpecifier file;
+        short index;
+        short slot;
+        uint32 ticket;
+    };
+
+    struct DecodedSound {
+        Sound sound;
+        short index;
+        short slot;
+        uint32 ticket;
+    };
+
+    void Link(Entry* entry);
+    void Unlink(Entry* entry);
+    void CancelDecodes(short index);
+    void LoaderLoop();
+
+    std::unordered_map<short, Entry> m_entries;
     std::size_t m_size;
     std::size_t m_max_size;
+    Entry* m_newest;
+    Entry* m_oldest;
+
+    // decodes still wanted, by (index, slot); only touched on the calling thread
+    std::unordered_map<std::pair<short, short>, uint32> m_pending;
+    uint32 m_next_ticket;
+
+    std::thread m_loader;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<DecodeRequest> m_requests;
+    std::vector<DecodedSound> m_decoded;
+    bool m_quit;
+    std::atomic<bool> m_has_decoded;
 };
 
-void SoundMemoryManager::Add(std::shared_ptr<SoundData> data, short index, short slot) {
-    m_entries[index].data[slot]  = data;
-    m_entries[index].last_played = machine_tick_count();
+void SoundMemoryManager::Link(Entry* entry) {
+    entry->newer = nullptr;
+    entry->older = m_newest;
+    if (m_newest) {
+        m_newest->newer = entry;
+    } else {
+        m_oldest = entry;
+    }
+    m_newest = entry;
+}
+
+void SoundMemoryManager::Unlink(Entry* entry) {
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        m_newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        m_oldest = entry->newer;
+    }
+    entry->newer = entry->older = nullptr;
+}
+
+void SoundMemoryManager::Add(const Sound& sound, short index, short slot) {
+    auto inserted = m_entries.emplace(index, Entry(index));
+    Entry* entry  = &inserted.first->second;
+    if (inserted.second) {
+        Link(entry);
+    } else {
+        Update(index);
+    }
 
-    m_size += data->size();
+    auto& old = entry->sounds[slot].data;
+    if (old.get()) {
+        m_size -= old->size();
+    }
+    entry->sounds[slot]  = sound;
+    m_size              += sound.data->size();
 
-    while (m_size > m_max_size) {
-        std::cerr << "Size is too big (" << m_size << ">" << m_max_size << ")" << std::endl;
-        ReleaseOldestSound();
+    // never the sound being added, even if it's bigger than the budget on its own
+    while (m_size > m_max_size && m_oldest != entry) {
+        Release(m_oldest->index);
     }
 }
 
 void SoundMemoryManager::Release(short index) {
+    CancelDecodes(index);
+
+    auto it = m_entries.find(index);
+    if (it == m_entries.end()) {
+        return;
+    }
+
     if (SoundReleased) {
         SoundReleased(index);
     }
-    m_size -= m_entries[index].size();
-    m_entries.erase(index);
+    Unlink(&it->second);
+    m_size -= it->second.size();
+    m_entries.erase(it);
+}
+
+void SoundMemoryManager::Clear() {
+    m_entries.clear();
+    m_newest = m_oldest = nullptr;
+    m_size              = 0;
+
+    m_pending.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.clear();
+}
+
+void SoundMemoryManager::Update(short index) {
+    Entry* entry = &m_entries.find(index)->second;
+    if (entry != m_newest) {
+        Unlink(entry);
+        Link(entry);
+    }
+}
+
+void SoundMemoryManager::CancelDecodes(short index) {
+    for (short slot = 0; slot < SoundDefinition::MAXIMUM_PERMUTATIONS_PER_SOUND; ++slot) {
+        m_pending.erase(std::make_pair(index, slot));
+    }
 }
 
-void SoundMemoryManager::ReleaseOldestSound() {
-    if (!m_entries.size()) {
+void SoundMemoryManager::Decode(const FileSpecifier& file, short index, short slot) {
+    auto inserted = m_pending.emplace(std::make_pair(index, slot), m_next_ticket);
+    if (!inserted.second) {
+        return; // already on its way
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_loader.joinable()) {
+        m_quit   = false;
+        m_loader = std::thread(&SoundMemoryManager::LoaderLoop, this);
+    }
+    m_requests.push_back({file, index, slot, m_next_ticket++});
+    m_wake.notify_one();
+}
+
+void SoundMemoryManager::SwapInDecoded() {
+    if (!m_has_decoded.load(std::memory_order_acquire)) {
         return;
     }
 
-    std::map<short, Entry>::iterator oldest_sound = m_entries.begin();
-    std::map<short, Entry>::iterator it           = oldest_sound;
-    ++it;
-    for (; it != m_entries.end(); ++it) {
-        if (it->second.last_played < oldest_sound->second.last_played) {
-            oldest_sound = it;
+    std::vector<DecodedSound> decoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        decoded.swap(m_decoded);
+        m_has_decoded.store(false, std::memory_order_relaxed);
+    }
+
+    for (auto& it : decoded) {
+        // dropped if the sound was released, or asked for again, since it was queued
+        auto pending = m_pending.find(std::make_pair(it.index, it.slot));
+        if (pending == m_pending.end() || pending->second != it.ticket) {
+            continue;
+        }
+        m_pending.erase(pending);
+
+        // if it didn't decode, whatever is loaded for the slot stays
+        if (it.sound.data.get()) {
+            Add(it.sound, it.index, it.slot);
         }
     }
+}
 
-    std::cerr << "Dropping sound " << oldest_sound->first << std::endl;
-    Release(oldest_sound->first);
+void SoundMemoryManager::StopLoader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_loader.joinable()) {
+            return;
+        }
+        m_quit = true;
+        m_requests.clear();
+        m_wake.notify_one();
+    }
+    m_loader.join();
+    m_pending.clear();
 }
 
-void SoundMemoryManager::Update(short index) { m_entries[index].last_played = machine_tick_count(); }
+void SoundMemoryManager::LoaderLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_quit || !m_requests.empty(); });
+        if (m_quit) {
+            return;
+        }
+
+        DecodeRequest request = m_requests.front();
+        m_requests.pop_front();
+        lock.unlock();
+
+        // the header is decoded into a copy; the replacement's own one is shared with the tick thread
+        ExternalSoundHeader header;
+        DecodedSound decoded = {Sound(), request.index, request.slot, request.ticket};
+        decoded.sound.data   = header.LoadExternal(request.file);
+        decoded.sound.header = header;
+
+        lock.lock();
+        m_decoded.push_back(std::move(decoded));
+        m_has_decoded.store(true, std::memory_order_release);
+    }
+}
 
 static void Shutdown() {
     SoundManager::instance()->Shutdown();
@@ -178,6 +360,7 @@ void SoundManager::SetParameters(const Parameters& parameters) {
 }
 
 void SoundManager::Shutdown() {
+    instance()->sounds->StopLoader();
     instance()->SetStatus(false);
     instance()->CloseSoundFile();
 }
@@ -261,22 +444,20 @@ bool SoundManager::LoadSound(short sound_index) {
         return false;
     }
 
+    sounds->SwapInDecoded();
     if (sounds->IsLoaded(sound_index)) {
         sounds->Update(sound_index);
     } else {
         for (int i = 0; i < NumSlots; ++i) {
-            auto p = sound_file->GetSoundData(definition, i);
+            Sound sound = {sound_file->GetSoundHeader(definition, i), sound_file->GetSoundData(definition, i)};
+            if (sound.data.get()) {
+                sounds->Add(sound, sound_index, i);
+            }
 
+            // the replacement takes the slot over once it's decoded
             SoundOptions* SndOpts = SoundReplacements::instance()->GetSoundOptions(sound_index, i);
             if (SndOpts) {
-                auto x = SndOpts->Sound.LoadExternal(SndOpts->File);
-                if (x.get()) {
-                    p = x;
-                }
-            }
-
-            if (p.get()) {
-                sounds->Add(p, sound_index, i);
+                sounds->Decode(SndOpts->File, sound_index, i);
             }
         }
     }
@@ -298,9 +479,7 @@ void SoundManager::StopSound(short identifier, short sound_index) {
 
 void SoundManager::UnloadSound(short sound_index) {
     StopSound(NONE, sound_index);
-    if (sounds->IsLoaded(sound_index)) {
-        sounds->Release(sound_index);
-    }
+    sounds->Release(sound_index);
 }
 
 void SoundManager::UnloadAllSounds() {
@@ -363,6 +542,10 @@ std::shared_ptr<SoundPlayer>
     if (sound_index == NONE || !active || OpenALManager::Get()->GetMasterVolume() <= 0 || !LoadSound(sound_index))
         return std::shared_ptr<SoundPlayer>();
 
+    // the real tick will play it again
+    if (world_update_is_predictive())
+        return std::shared_ptr<SoundPlayer>();
+
     SoundParameters parameters;
     parameters.identifier        = sound_index;
     parameters.pitch             = pitch;
@@ -478,6 +661,7 @@ void SoundManager::UpdateListener() {
 }
 
 void SoundManager::Idle() {
+    sounds->SwapInDecoded();
     UpdateListener();
     CauseAmbientSoundSourceUpdate();
     ManagePlayers();
@@ -659,7 +843,7 @@ SoundManager::Parameters::Parameters()
     : volume_db(DEFAULT_SOUND_LEVEL_DB),
       flags(_more_sounds_flag | _dynamic_tracking_flag | _ambient_sound_flag | _16bit_sound_flag), rate(DEFAULT_RATE),
       samples(DEFAULT_SAMPLES), music_db(DEFAULT_MUSIC_LEVEL_DB),
-      video_export_volume_db(DEFAULT_VIDEO_EXPORT_VOLUME_DB), channel_type(ChannelType::_stereo) {}
+      video_export_volume_db(DEFAULT_VIDEO_EXPORT_VOLUME_DB), channel_type(ChannelType::_stereo), cache_mb(0) {}
 
 bool SoundManager::Parameters::Verify() {
     if (volume_db < MINIMUM_VOLUME_DB) {
@@ -679,7 +863,7 @@ void SoundManager::SetStatus(bool active) {
 
     if (active) {
         sounds->Clear();
-        uint32 total_buffer_size;
+        std::size_t total_buffer_size;
 
         if (parameters.flags & _more_sounds_flag)
             total_buffer_size = MORE_SOUND_BUFFER_SIZE;
@@ -693,6 +877,9 @@ void SoundManager::SetStatus(bool active) {
 
         total_buffer_size *= 16;
 
+        if (parameters.cache_mb)
+            total_buffer_size = static_cast<std::size_t>(parameters.cache_mb) * MEG;
+
         sounds->SetMaxSize(total_buffer_size);
 
         sound_source = (parameters.flags & _16bit_sound_flag) ? _16bit_22k_source : _8bit_22k_source;
@@ -781,22 +968,13 @@ std::shared_ptr<SoundPlayer> SoundManager::BufferSound(SoundParameters parameter
 
     assert(permutation >= 0 && permutation < definition->permutations);
 
-    SoundInfo header;
-
-    SoundOptions* SndOpts = SoundReplacements::instance()->GetSoundOptions(parameters.identifier, permutation);
-    if (SndOpts && SndOpts->Sound.length) {
-        header = SndOpts->Sound;
-    } else {
-        header = sound_file->GetSoundHeader(definition, permutation);
-    }
-
     auto sound = sounds->Get(parameters.identifier, permutation);
-    if (sound.get()) {
+    if (sound.data.get()) {
         parameters.pitch     = CalculatePitchModifier(parameters.identifier, parameters.pitch);
         parameters.flags    |= definition->flags;
         parameters.behavior  = (sound_behavior)definition->behavior_index;
 
-        return ManageSound({header, sound}, parameters);
+        return ManageSound(sound, parameters);
     }
 
     return returnedPlayer;
@@ -121,6 +121,8 @@ class SoundManager {
 
         ChannelType channel_type;
 
+        uint16 cache_mb; // memory for loaded sounds, 0 to size it from the flags
+
         Parameters();
         bool Verify();
     } parameters;
@@ -419,6 +419,7 @@ size_t saved_game_was_networked(FileSpecifier& saved_game) {
 }
 
 bool load_quick_save_dialog(FileSpecifier& saved_game) {
+    finish_saved_games(true);
     QuickSaves::instance()->enumerate();
 
     dialog d;
@@ -500,11 +501,12 @@ bool load_quick_save_dialog(FileSpecifier& saved_game) {
 extern SDL_Surface* draw_surface;
 extern bool OGL_MapActive;
 
-static bool build_map_preview(std::ostringstream& ostream) {
+// drawn on the main thread, since the overhead map reads the world as it is now
+static SDL_Surface* render_map_preview() {
     SDL_Rect r           = {0, 0, RENDER_WIDTH, RENDER_HEIGHT};
     SDL_Surface* surface = SDL_CreateRGBSurface(SDL_SWSURFACE, r.w, r.h, 32, 0xff'0000, 0x00'ff00, 0x00'00ff, 0);
     if (!surface)
-        return false;
+        return NULL;
 
     SDL_FillRect(surface, &r, SDL_MapRGB(surface->format, 0, 0, 0));
 
@@ -526,6 +528,15 @@ static bool build_map_preview(std::ostringstream& ostream) {
     OGL_MapActive = old_OGL_MapActive;
     _restore_port();
 
+    return surface;
+}
+
+// encoded with the rest of the save, in the background; frees the surface
+static std::string encode_map_preview(SDL_Surface* surface) {
+    if (!surface)
+        return std::string();
+
+    std::ostringstream ostream;
     SDL_RWops* rwops = SDL_RWFromOStream(ostream);
 // #if defined(HAVE_PNG) && defined(HAVE_SDL_IMAGE)
 //     int ret = aoIMG_SavePNG_RW(rwops, surface, IMG_COMPRESS_DEFAULT, NULL, 0);
@@ -537,7 +548,7 @@ static bool build_map_preview(std::ostringstream& ostream) {
     SDL_FreeSurface(surface);
     SDL_RWclose(rwops);
 
-    return (ret == 0);
+    return (ret == 0) ? ostream.str() : std::string();
 }
 
 std::string build_save_metadata(QuickSave& save) {
@@ -671,12 +682,13 @@ bool create_quick_save(void) {
     save.save_file.AddPart(base + ".sgaA");
 
     std::string metadata = build_save_metadata(save);
-    std::ostringstream image_stream;
-    bool success = build_map_preview(image_stream);
-    success      = save_game_file(save.save_file, metadata, image_stream.str());
+    SDL_Surface* preview = render_map_preview();
+    bool success         = save_game_file_in_background(
+            save.save_file, metadata, [preview] { return encode_map_preview(preview); },
+            [save](bool saved) { QuickSaves::instance()->saved(save, saved); });
 
-    if (success)
-        QuickSaves::instance()->delete_surplus_saves(environment_preferences->maximum_quick_saves);
+    if (!success && preview)
+        SDL_FreeSurface(preview);
     return success;
 }
 
@@ -771,6 +783,12 @@ void QuickSaves::enumerate() {
 
 void QuickSaves::clear() { m_saves.clear(); }
 
+void QuickSaves::saved(const QuickSave& save, bool success) {
+    screen_printf(success ? "Game saved" : "Save failed");
+    if (success)
+        delete_surplus_saves(environment_preferences->maximum_quick_saves);
+}
+
 bool most_recent_dir_entry(const dir_entry& a, const dir_entry& b) { return a.date > b.date; }
 
 void QuickSaves::delete_surplus_saves(size_t max_saves) {
@@ -58,6 +58,8 @@ class QuickSaves {
     void enumerate();
     void clear();
     void delete_surplus_saves(size_t max_saves);
+    // called on the main thread once a save written in the background is done
+    void saved(const QuickSave& save, bool success);
 
     iterator begin() { return m_saves.begin(); }
 
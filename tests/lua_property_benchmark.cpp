@@ -0,0 +1,292 @@
+/*
+ *  L_Class property dispatch, with its method tables as upvalues and L_Validator,
+ *  next to a copy of the registry lookup and pcall per accessor it replaced. Getters,
+ *  setters, "_" custom fields, unknown keys and invalid objects must look the same
+ *  from Lua through either. The hidden "[Lua][benchmark]" case loops reads and writes.
+ */
+
+#include "lua_script.hpp"
+#include "lua_templates.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+
+char Lua_BenchObject_Name[] = "bench_object";
+typedef L_Class<Lua_BenchObject_Name> Lua_BenchObject;
+
+char Lua_LegacyObject_Name[] = "legacy_object";
+struct Lua_LegacyObject : public L_Class<Lua_LegacyObject_Name> {
+    using L_Class<Lua_LegacyObject_Name>::_push_custom_fields_table;
+};
+
+static int16 bench_values[2];
+
+template <class T>
+static int get_x(lua_State* L) {
+    lua_pushnumber(L, bench_values[T::Index(L, 1)]);
+    return 1;
+}
+
+template <class T>
+static int set_x(lua_State* L) {
+    bench_values[T::Index(L, 1)] = static_cast<int16>(luaL_checknumber(L, 2));
+    return 0;
+}
+
+static const luaL_Reg Lua_BenchObject_Get[] = {
+        {"x", get_x<Lua_BenchObject>},
+        {0,   0                     }
+};
+
+static const luaL_Reg Lua_BenchObject_Set[] = {
+        {"x", set_x<Lua_BenchObject>},
+        {0,   0                     }
+};
+
+static const luaL_Reg Lua_LegacyObject_Get[] = {
+        {"x", get_x<Lua_LegacyObject>},
+        {0,   0                      }
+};
+
+static const luaL_Reg Lua_LegacyObject_Set[] = {
+        {"x", set_x<Lua_LegacyObject>},
+        {0,   0                      }
+};
+
+// L_Class::Valid and ValidRange as they were before L_Validator
+static std::function<bool(int16)> legacy_valid;
+
+struct LegacyValidRange {
+    LegacyValidRange(int32 max_index) : m_max(max_index) {}
+
+    bool operator()(int32 index) { return (index >= 0 && index < m_max); }
+
+    int32 m_max;
+};
+
+// L_Class::_get and L_Class::_set as they were before the method tables became upvalues
+static int legacy_get(lua_State* L) {
+    if (lua_isstring(L, 2)) {
+        luaL_checktype(L, 1, LUA_TUSERDATA);
+        luaL_checkudata(L, 1, Lua_LegacyObject_Name);
+        if (!legacy_valid(Lua_LegacyObject::Index(L, 1)) && strcmp(lua_tostring(L, 2), "valid") != 0 &&
+            strcmp(lua_tostring(L, 2), "index") != 0)
+            luaL_error(L, "invalid object");
+
+        if (lua_tostring(L, 2)[0] == '_') {
+            Lua_LegacyObject::_push_custom_fields_table(L);
+            lua_pushnumber(L, Lua_LegacyObject::Index(L, 1));
+            lua_gettable(L, -2);
+            if (lua_istable(L, -1)) {
+                lua_pushvalue(L, 2);
+                lua_gettable(L, -2);
+                lua_remove(L, -2);
+            } else {
+                lua_pop(L, 1);
+                lua_pushnil(L);
+            }
+
+            lua_remove(L, -2);
+        } else {
+            lua_pushlightuserdata(L, (void*)(&Lua_LegacyObject_Name[1]));
+            lua_gettable(L, LUA_REGISTRYINDEX);
+
+            lua_pushvalue(L, 2);
+            lua_gettable(L, -2);
+            lua_remove(L, -2);
+
+            if (lua_isfunction(L, -1)) {
+                lua_pushvalue(L, 1);
+                if (lua_pcall(L, 1, 1, 0) == LUA_ERRRUN) {
+                    luaL_where(L, 1);
+                    lua_pushvalue(L, -2);
+                    lua_concat(L, 2);
+                    lua_error(L);
+                }
+            } else {
+                lua_pop(L, 1);
+                lua_pushnil(L);
+            }
+        }
+    } else {
+        lua_pushnil(L);
+    }
+
+    return 1;
+}
+
+static int legacy_set(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TUSERDATA);
+    luaL_checkudata(L, 1, Lua_LegacyObject_Name);
+
+    if (lua_isstring(L, 2) && lua_tostring(L, 2)[0] == '_') {
+        Lua_LegacyObject::_push_custom_fields_table(L);
+        lua_pushnumber(L, Lua_LegacyObject::Index(L, 1));
+        lua_gettable(L, -2);
+        if (lua_istable(L, -1)) {
+            lua_pushvalue(L, 2);
+            lua_pushvalue(L, 3);
+            lua_settable(L, -3);
+            lua_pop(L, 1);
+        } else {
+            lua_pop(L, 1);
+
+            lua_newtable(L);
+
+            lua_pushnumber(L, Lua_LegacyObject::Index(L, 1));
+            lua_pushvalue(L, -2);
+            lua_settable(L, -4);
+
+            lua_pushvalue(L, 2);
+            lua_pushvalue(L, 3);
+            lua_settable(L, -3);
+            lua_pop(L, 1);
+        }
+
+        lua_pop(L, 1);
+    } else {
+        lua_pushlightuserdata(L, (void*)(&Lua_LegacyObject_Name[2]));
+        lua_gettable(L, LUA_REGISTRYINDEX);
+
+        lua_pushvalue(L, 2);
+        lua_gettable(L, -2);
+
+        if (lua_isnil(L, -1)) {
+            luaL_error(L, "no such index");
+        }
+
+        lua_pushvalue(L, 1);
+        lua_pushvalue(L, 3);
+        if (lua_pcall(L, 2, 0, 0) == LUA_ERRRUN) {
+            luaL_where(L, 1);
+            lua_pushvalue(L, -2);
+            lua_concat(L, 2);
+            lua_error(L);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    return 0;
+}
+
+// "bench" is object 0 through L_Class, "legacy" is object 1 through the old dispatch
+static lua_State* new_bench_state() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    lua_pushlightuserdata(L, L_Persistent_Table_Key());
+    lua_newtable(L);
+    lua_settable(L, LUA_REGISTRYINDEX);
+
+    Lua_BenchObject::Register(L, Lua_BenchObject_Get, Lua_BenchObject_Set);
+    Lua_BenchObject::Valid = Lua_BenchObject::ValidRange(1);
+    Lua_BenchObject::Push(L, 0);
+    lua_setglobal(L, "bench");
+
+    Lua_LegacyObject::Register(L, Lua_LegacyObject_Get, Lua_LegacyObject_Set);
+    legacy_valid = LegacyValidRange(2);
+    luaL_getmetatable(L, Lua_LegacyObject_Name);
+    lua_pushcfunction(L, legacy_get);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, legacy_set);
+    lua_setfield(L, -2, "__newindex");
+    lua_pop(L, 1);
+    Lua_LegacyObject::Push(L, 1);
+    lua_setglobal(L, "legacy");
+
+    return L;
+}
+
+// runs chunk with the named object as its argument; returns its result (or error message),
+// and whether it ran without error
+static std::pair<bool, std::string> run_chunk(lua_State* L, const char* chunk, const char* global) {
+    REQUIRE(luaL_loadstring(L, chunk) == LUA_OK);
+    lua_getglobal(L, global);
+    bool ok            = lua_pcall(L, 1, 1, 0) == LUA_OK;
+    std::string result = lua_isnil(L, -1) ? "nil" : lua_tostring(L, -1);
+    lua_pop(L, 1);
+    return {ok, result};
+}
+
+static bool fails_with(const std::pair<bool, std::string>& result, const char* message) {
+    return !result.first && result.second.find(message) != std::string::npos;
+}
+
+TEST_CASE("L_Class properties behave as through the old dispatch", "[Lua]") {
+    lua_State* L = new_bench_state();
+
+    const char* chunks[] = {
+            "local o = ...; o.x = 42; return o.x",
+            "local o = ...; o.x = -3.75; return o.x",
+            "local o = ...; return o.y",
+            "local o = ...; o._tag = 'marked'; return o._tag",
+            "local o = ...; return o._untagged",
+            "local o = ...; return o[1]",
+            "local o = ...; o.y = 1",
+            "local o = ...; o.x = 'nonsense'",
+    };
+
+    // argument errors name a different function in each, so only their outcome is compared
+    for (auto chunk : chunks) {
+        INFO(chunk);
+        auto expected = run_chunk(L, chunk, "bench");
+        auto actual   = run_chunk(L, chunk, "legacy");
+        CHECK(actual.first == expected.first);
+        if (expected.first)
+            CHECK(actual.second == expected.second);
+    }
+
+    CHECK(run_chunk(L, "local o = ...; o.x = 42; return o.x", "bench").second == "42");
+    CHECK(bench_values[0] == 42);
+    CHECK(run_chunk(L, "local o = ...; o.x = 7; return o.x", "legacy").second == "7");
+    CHECK(bench_values[1] == 7);
+    CHECK(run_chunk(L, "local o = ...; return o.index", "bench").second == "0");
+    CHECK(run_chunk(L, "local o = ...; return o.index", "legacy").second == "1");
+    CHECK(fails_with(run_chunk(L, "local o = ...; o.y = 1", "bench"), "no such index"));
+    CHECK(fails_with(run_chunk(L, "local o = ...; o.y = 1", "legacy"), "no such index"));
+
+    // neither reads from an invalid object, but both still give its index
+    Lua_BenchObject::Valid = Lua_BenchObject::ValidRange(0);
+    legacy_valid           = LegacyValidRange(0);
+    CHECK(fails_with(run_chunk(L, "local o = ...; return o.x", "bench"), "invalid object"));
+    CHECK(fails_with(run_chunk(L, "local o = ...; return o.x", "legacy"), "invalid object"));
+    CHECK(run_chunk(L, "local o = ...; return o.index", "bench").second == "0");
+    CHECK(run_chunk(L, "local o = ...; return o.index", "legacy").second == "1");
+
+    lua_close(L);
+}
+
+static const char* bench_script = "local object, n = ...\n"
+                                  "local sum = 0\n"
+                                  "for i = 1, n do\n"
+                                  "  sum = sum + object.x\n"
+                                  "  object.x = i % 100\n"
+                                  "end\n"
+                                  "return sum\n";
+
+// one read and one write per iteration
+static const int bench_iterations = 100000;
+
+static double run(lua_State* L, const char* global) {
+    luaL_loadstring(L, bench_script);
+    lua_getglobal(L, global);
+    lua_pushnumber(L, bench_iterations);
+    lua_pcall(L, 2, 1, 0);
+    double sum = lua_tonumber(L, -1);
+    lua_pop(L, 1);
+    return sum;
+}
+
+TEST_CASE("Lua property access benchmark", "[.][Lua][benchmark]") {
+    lua_State* L = new_bench_state();
+
+    BENCHMARK("registry + pcall") { return run(L, "legacy"); };
+    BENCHMARK("upvalues, direct") { return run(L, "bench"); };
+
+    lua_close(L);
+}
@@ -0,0 +1,196 @@
+/*
+ *  Script state saves for scenarios with large Lua tables. A version 1 save, a version 2
+ *  save, and version 2 deltas taken tick after tick must each restore to a state equal
+ *  to the one saved, and a delta must come out smaller than a full save.
+ *
+ *  Save times for each format: Tests "[Lua][benchmark]"
+ */
+
+#include "BStream.hpp"
+#include "lua_serialize.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+
+// builds the persistent table a script with many tracked entities would have
+static const char* build_script = "local kinds = {'trooper', 'fighter', 'enforcer', 'hunter', 'juggernaut'}\n"
+                                  "local state = {entities = {}, log = {}, flags = {}}\n"
+                                  "for i = 1, 2000 do\n"
+                                  "  state.entities[i] = {x = i * 3, y = i * 5, z = 0, kind = kinds[i % 5 + 1],\n"
+                                  "                       alive = true, route = {i, i + 1, i + 2}}\n"
+                                  "end\n"
+                                  "for i = 1, 500 do state.log[i] = 'checkpoint ' .. (i % 20) end\n"
+                                  "for i = 1, 100 do state.flags['flag_' .. i] = (i % 3 == 0) end\n"
+                                  "return state\n";
+
+// a tick's worth of changes: a few entities move, one dies
+static const char* change_script = "local state, tick = ...\n"
+                                   "for i = 1, 20 do\n"
+                                   "  local e = state.entities[(tick * 37 + i * 101) % 2000 + 1]\n"
+                                   "  e.x = e.x + 1\n"
+                                   "end\n"
+                                   "state.entities[tick % 2000 + 1].alive = false\n";
+
+static const char* equal_script = "local function equal(a, b, seen)\n"
+                                  "  if type(a) ~= 'table' or type(b) ~= 'table' then return a == b end\n"
+                                  "  if seen[a] then return seen[a] == b end\n"
+                                  "  seen[a] = b\n"
+                                  "  for k, v in pairs(a) do if not equal(v, b[k], seen) then return false end end\n"
+                                  "  for k in pairs(b) do if a[k] == nil then return false end end\n"
+                                  "  return true\n"
+                                  "end\n"
+                                  "local a, b = ...\n"
+                                  "return equal(a, b, {})\n";
+
+// the version 1 writer, as it was
+static void save_v1(lua_State* L, BOStreamBE& s, uint32& counter) {
+    lua_pushvalue(L, -1);
+    lua_rawget(L, 1);
+    if (!lua_isnil(L, -1)) {
+        s << static_cast<int8>(-2) << static_cast<uint32>(lua_tonumber(L, -1));
+        lua_pop(L, 1);
+        return;
+    }
+    lua_pop(L, 1);
+
+    s << static_cast<int8>(lua_type(L, -1));
+    switch (lua_type(L, -1)) {
+        case LUA_TNUMBER:
+            s << static_cast<double>(lua_tonumber(L, -1));
+            break;
+        case LUA_TBOOLEAN:
+            s << static_cast<uint8>(lua_toboolean(L, -1) ? 1 : 0);
+            break;
+        case LUA_TSTRING:
+            s << static_cast<uint32>(lua_rawlen(L, -1));
+            s.write(lua_tostring(L, -1), lua_rawlen(L, -1));
+            break;
+        case LUA_TTABLE:
+            lua_pushvalue(L, -1);
+            lua_pushnumber(L, static_cast<lua_Number>(++counter));
+            lua_rawset(L, 1);
+            s << counter;
+
+            lua_pushnil(L);
+            while (lua_next(L, -2)) {
+                lua_pushvalue(L, -2);
+                save_v1(L, s, counter);
+                lua_pop(L, 1);
+                save_v1(L, s, counter);
+                lua_pop(L, 1);
+            }
+
+            lua_pushnil(L);
+            save_v1(L, s, counter);
+            lua_pop(L, 1);
+            break;
+    }
+}
+
+static std::string lua_save_v1(lua_State* L) {
+    lua_newtable(L);
+    lua_insert(L, 1);
+
+    std::stringbuf sb;
+    BOStreamBE s(&sb);
+    uint32 counter = 0;
+    s << static_cast<uint16>(1);
+    save_v1(L, s, counter);
+
+    lua_remove(L, 1);
+    return sb.str();
+}
+
+static bool restores_equal(lua_State* L, const std::string& data, LuaSnapshotReader* reader = nullptr) {
+    std::stringbuf sb(data);
+    bool restored = reader ? reader->restore(L, &sb) : lua_restore(L, &sb);
+    if (!restored)
+        return false;
+
+    luaL_loadstring(L, equal_script);
+    lua_pushvalue(L, 1);
+    lua_pushvalue(L, -3);
+    lua_call(L, 2, 1);
+    bool equal = lua_toboolean(L, -1);
+    lua_pop(L, 2);
+    return equal;
+}
+
+static void change(lua_State* L, int tick) {
+    luaL_loadstring(L, change_script);
+    lua_pushvalue(L, 1);
+    lua_pushnumber(L, tick);
+    lua_call(L, 2, 0);
+}
+
+// the state stays at the bottom of the stack
+static lua_State* new_state() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    if (luaL_dostring(L, build_script))
+        FAIL(lua_tostring(L, -1));
+
+    return L;
+}
+
+static std::string lua_save_v2(lua_State* L) {
+    std::stringbuf sb;
+    lua_save(L, &sb);
+    return sb.str();
+}
+
+TEST_CASE("Lua saves and deltas restore the saved state", "[Lua]") {
+    lua_State* L = new_state();
+
+    std::string v1 = lua_save_v1(L);
+    std::string v2 = lua_save_v2(L);
+    CHECK(restores_equal(L, v1));
+    CHECK(restores_equal(L, v2));
+
+    // deltas, each restored in turn by a reader that follows along
+    LuaSnapshotWriter writer;
+    LuaSnapshotReader reader;
+    std::stringbuf first;
+    writer.save(L, &first, false);
+    CHECK(restores_equal(L, first.str(), &reader));
+
+    for (int tick = 0; tick < 20; ++tick) {
+        INFO("tick " << tick);
+        change(L, tick);
+
+        std::stringbuf sb;
+        writer.save(L, &sb, true);
+        std::string delta = sb.str();
+        CHECK(delta.size() < v2.size());
+        CHECK(restores_equal(L, delta, &reader));
+    }
+
+    // the full save still restores once deltas have been taken
+    CHECK(restores_equal(L, lua_save_v2(L)));
+
+    lua_close(L);
+}
+
+TEST_CASE("Lua state save benchmark", "[.][Lua][benchmark]") {
+    lua_State* L = new_state();
+
+    BENCHMARK("version 1 full") { return lua_save_v1(L).size(); };
+    BENCHMARK("version 2 full") { return lua_save_v2(L).size(); };
+
+    LuaSnapshotWriter writer;
+    std::stringbuf first;
+    writer.save(L, &first, false);
+
+    int tick = 0;
+    BENCHMARK("version 2 delta, with a tick's changes") {
+        change(L, tick++);
+
+        std::stringbuf sb;
+        writer.save(L, &sb, true);
+        return sb.str().size();
+    };
+
+    lua_close(L);
+}
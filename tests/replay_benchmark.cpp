@@ -0,0 +1,135 @@
+/*
+ *  Replays every film in a directory as fast as possible, without drawing or sound,
+ *  and reports how fast the world simulation ran. Hidden from the default run:
+ *
+ *  Tests [data directory] -l [replay directory] "[benchmark]"
+ */
+
+#include "FileHandler.hpp"
+#include "interface.hpp"
+#include "map.hpp"
+#include "shell.hpp"
+#include "shell_options.hpp"
+
+#include <SDL.h>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef __WIN32__
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+extern ShellOptions shell_options;
+
+static const char* section_names[NUMBER_OF_WORLD_PROFILE_SECTIONS] = {
+        "lua idle", "lights", "media", "platforms", "players", "projectiles", "monsters", "effects", "other"};
+
+static std::vector<std::string> get_films(std::string& directory_path) {
+    FileSpecifier directory = directory_path;
+
+    std::vector<dir_entry> entries;
+    directory.ReadDirectory(entries);
+
+    std::vector<std::string> results;
+    for (const auto& it : entries) {
+        FileSpecifier entry    = directory + it.name;
+        std::string entry_path = entry.GetPath();
+
+        if (entry.IsDir()) {
+            auto sub_films = get_films(entry_path);
+            results.insert(results.end(), sub_films.begin(), sub_films.end());
+        } else if (entry.GetType() == _typecode_film) {
+            results.push_back(entry_path);
+        }
+    }
+
+    return results;
+}
+
+// in kilobytes
+static long peak_memory_usage() {
+#ifdef __WIN32__
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#if defined(__APPLE__) && defined(__MACH__)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static void print_profile(const char* name, const world_update_profile& profile, double seconds) {
+    double simulated = 0;
+    for (auto section_seconds : profile.seconds) simulated += section_seconds;
+
+    printf("%s\n", name);
+    printf("  %lld ticks in %.3f s: %.0f ticks/s (%.0f ticks/s simulating)\n",
+           static_cast<long long>(profile.ticks), seconds, seconds > 0 ? profile.ticks / seconds : 0.0,
+           simulated > 0 ? profile.ticks / simulated : 0.0);
+
+    for (int i = 0; i < NUMBER_OF_WORLD_PROFILE_SECTIONS; ++i) {
+        printf("  %-12s %9.3f ms %5.1f%%\n", section_names[i], profile.seconds[i] * 1000,
+               simulated > 0 ? 100 * profile.seconds[i] / simulated : 0.0);
+    }
+}
+
+TEST_CASE("Film replay benchmark", "[.][Replay][benchmark]") {
+    REQUIRE(!shell_options.directory.empty());
+    REQUIRE(!shell_options.replay_directory.empty());
+
+    // no window, renderer or audio
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    shell_options.nogl       = true;
+    shell_options.nosound    = true;
+    shell_options.nojoystick = true;
+    shell_options.headless   = true;
+
+    const auto films = get_films(shell_options.replay_directory);
+    REQUIRE(!films.empty());
+
+    initialize_application();
+    set_world_update_profiling(true);
+
+    world_update_profile total = world_update_profile();
+    double total_seconds       = 0;
+
+    for (const auto& film : films) {
+        INFO(film);
+        reset_world_update_profile();
+
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(handle_open_document(film));
+        set_replay_speed(INT16_MAX);
+        main_event_loop();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto& profile  = get_world_update_profile();
+        total.ticks         += profile.ticks;
+        for (int i = 0; i < NUMBER_OF_WORLD_PROFILE_SECTIONS; ++i) total.seconds[i] += profile.seconds[i];
+        total_seconds += seconds;
+
+        print_profile(film.c_str(), profile, seconds);
+    }
+
+    print_profile("total", total, total_seconds);
+    printf("peak memory: %ld KB\n", peak_memory_usage());
+
+    set_world_update_profiling(false);
+    shutdown_application();
+}
@@ -0,0 +1,125 @@
+/*
+ *  SlotAllocator against the scan from slot 0 it replaced for objects, projectiles and
+ *  effects. Through spawn/destroy churn, at table sizes on either side of its 64-bit
+ *  words and after slots are rewritten behind its back, it has to pick the same slot
+ *  the scan would. "[SlotAllocator][benchmark]" times one spawn in a nearly full table.
+ */
+
+#include "SlotAllocator.hpp"
+#include "map.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+// how _new_map_object() found a slot before
+static short scan_for_free(const std::vector<object_data>& slots) {
+    for (size_t index = 0; index < slots.size(); ++index) {
+        if (SLOT_IS_FREE(&slots[index]))
+            return static_cast<short>(index);
+    }
+    return NONE;
+}
+
+// the same pseudorandom slots for both
+static uint32 next_random(uint32& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8;
+}
+
+// fills every slot, then leaves one in a hundred free
+template <class FindFree, class MarkUsed, class MarkFree>
+static void fill(std::vector<object_data>& slots, uint32& seed, FindFree find_free, MarkUsed mark_used,
+                 MarkFree mark_free) {
+    size_t count = slots.size();
+
+    for (size_t i = 0; i < count; ++i) {
+        short index = find_free();
+        MARK_SLOT_AS_USED(&slots[index]);
+        mark_used(index);
+    }
+    for (size_t i = 0; i < count / 100; ++i) {
+        short index = static_cast<short>(next_random(seed) % count);
+        if (SLOT_IS_USED(&slots[index])) {
+            MARK_SLOT_AS_FREE(&slots[index]);
+            mark_free(index);
+        }
+    }
+}
+
+// destroys a random object, if its slot is used, and spawns one; returns the spawned slot
+template <class FindFree, class MarkUsed, class MarkFree>
+static short churn(std::vector<object_data>& slots, uint32& seed, FindFree find_free, MarkUsed mark_used,
+                   MarkFree mark_free) {
+    short destroyed = static_cast<short>(next_random(seed) % slots.size());
+    if (SLOT_IS_USED(&slots[destroyed])) {
+        MARK_SLOT_AS_FREE(&slots[destroyed]);
+        mark_free(destroyed);
+    }
+
+    short index = find_free();
+    if (index != NONE) {
+        MARK_SLOT_AS_USED(&slots[index]);
+        mark_used(index);
+    }
+    return index;
+}
+
+TEST_CASE("SlotAllocator picks the lowest free slot", "[SlotAllocator]") {
+    const size_t counts[] = {1, 63, 64, 65, 4096, 4097, 32767};
+    const int spawn_count = 20000;
+    const auto no_op      = [](short) {};
+
+    for (auto count : counts) {
+        INFO(count << " slots");
+
+        std::vector<object_data> scan_slots(count), allocator_slots(count);
+        SlotAllocator<object_data> allocator(allocator_slots);
+        auto scan      = [&] { return scan_for_free(scan_slots); };
+        auto find_free = [&] { return allocator.find_free(); };
+        auto mark_used = [&](short index) { allocator.mark_used(index); };
+        auto mark_free = [&](short index) { allocator.mark_free(index); };
+
+        uint32 scan_seed = 1, allocator_seed = 1;
+        fill(scan_slots, scan_seed, scan, no_op, no_op);
+        fill(allocator_slots, allocator_seed, find_free, mark_used, mark_free);
+        CHECK(allocator.find_free() == scan_for_free(allocator_slots));
+
+        for (int i = 0; i < spawn_count; ++i) {
+            short scanned   = churn(scan_slots, scan_seed, scan, no_op, no_op);
+            short allocated = churn(allocator_slots, allocator_seed, find_free, mark_used, mark_free);
+            REQUIRE(allocated == scanned);
+        }
+
+        // the slots rewritten behind its back, as a restored game would
+        for (size_t index = 0; index < count; index += 3) MARK_SLOT_AS_FREE(&allocator_slots[index]);
+        invalidate_slot_allocators();
+        CHECK(allocator.find_free() == scan_for_free(allocator_slots));
+
+        for (auto& slot : allocator_slots) MARK_SLOT_AS_USED(&slot);
+        invalidate_slot_allocators();
+        CHECK(allocator.find_free() == NONE);
+    }
+}
+
+TEST_CASE("SlotAllocator benchmark", "[.][SlotAllocator][benchmark]") {
+    const size_t count = 32767;
+    const auto no_op   = [](short) {};
+
+    std::vector<object_data> scan_slots(count);
+    uint32 scan_seed = 1;
+    auto scan        = [&] { return scan_for_free(scan_slots); };
+    fill(scan_slots, scan_seed, scan, no_op, no_op);
+
+    BENCHMARK("scan from 0") { return churn(scan_slots, scan_seed, scan, no_op, no_op); };
+
+    std::vector<object_data> allocator_slots(count);
+    SlotAllocator<object_data> allocator(allocator_slots);
+    uint32 allocator_seed = 1;
+    auto find_free        = [&] { return allocator.find_free(); };
+    auto mark_used        = [&](short index) { allocator.mark_used(index); };
+    auto mark_free        = [&](short index) { allocator.mark_free(index); };
+    fill(allocator_slots, allocator_seed, find_free, mark_used, mark_free);
+
+    BENCHMARK("SlotAllocator") { return churn(allocator_slots, allocator_seed, find_free, mark_used, mark_free); };
+}